@@ -0,0 +1,74 @@
+//-------------------------------------------------------------------
+//  redis-cpp
+//  https://github.com/tdv/redis-cpp
+//  Created:     10.2026
+//  Copyright 2020 Dmitry Tkachenko (tkachenkodmitryv@gmail.com)
+//  Distributed under the MIT License
+//  (See accompanying file LICENSE)
+//-------------------------------------------------------------------
+
+// STD
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <redis-cpp/stream.h>
+#include <redis-cpp/execute.h>
+
+struct user
+{
+    std::string name;
+    std::int64_t age;
+};
+
+// Describes how the 'user' is decoded from an array reply (e.g. HMGET)
+template <>
+struct rediscpp::resp::decoding::struct_traits<user>
+{
+    static constexpr auto members = std::make_tuple(&user::name, &user::age);
+};
+
+int main()
+{
+    try
+    {
+        auto stream = rediscpp::make_stream("localhost", "6379");
+
+        auto const key = "my_user";
+
+        // The reply is parsed right into the target type
+        // without building a generic value.
+        auto const added = rediscpp::execute_as<std::int64_t>(*stream, "hset",
+                key, "name", "John", "age", "42");
+        std::cout << "Added fields: " << added << std::endl;
+
+        auto const fields = rediscpp::execute_as<
+                std::unordered_map<std::string, std::string>
+            >(*stream, "hgetall", key);
+        for (auto const &[field, value] : fields)
+            std::cout << field << ": " << value << std::endl;
+
+        auto const person = rediscpp::execute_as<user>(*stream, "hmget", key, "name", "age");
+        std::cout << "User: " << person.name << " (" << person.age << ")" << std::endl;
+
+        // Null is decoded into an empty optional instead of throwing an exception.
+        auto const missing = rediscpp::execute_as<std::optional<std::string>>(
+                *stream, "get", "my_missing_key");
+        std::cout << "Missing key: " << missing.value_or("<null>") << std::endl;
+
+        auto const numbers = rediscpp::execute_as<std::vector<std::int64_t>>(
+                *stream, "eval", "return {1, 2, 3}", "0");
+        for (auto i : numbers)
+            std::cout << "Number: " << i << std::endl;
+    }
+    catch (std::exception const &e)
+    {
+        std::cerr << "Error: " << e.what() << std::endl;
+        return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,408 @@
+//-------------------------------------------------------------------
+//  redis-cpp
+//  https://github.com/tdv/redis-cpp
+//  Created:     10.2026
+//  Copyright 2020 Dmitry Tkachenko (tkachenkodmitryv@gmail.com)
+//  Distributed under the MIT License
+//  (See accompanying file LICENSE)
+//-------------------------------------------------------------------
+
+#ifndef REDISCPP_AUTO_PIPELINE_H_
+#define REDISCPP_AUTO_PIPELINE_H_
+
+// STD
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <streambuf>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <type_traits>
+#include <utility>
+
+// REDIS-CPP
+#include <redis-cpp/detail/config.h>
+#include <redis-cpp/error.h>
+#include <redis-cpp/execute.h>
+#include <redis-cpp/resp/decoding.h>
+#include <redis-cpp/value.h>
+
+namespace rediscpp
+{
+
+struct auto_pipeline_options final
+{
+    // Bounds of the number of commands waiting for their replies.
+    std::size_t min_depth = 16;
+    std::size_t max_depth = 4096;
+    // The depth is also limited so that the replies in flight
+    // fit into this size, e.g. the socket receive buffer.
+    std::size_t max_reply_bytes = 1024 * 1024;
+    // Commands are written as soon as the previous write is completed.
+    // With a delay they are corked until the delay expires or
+    // 'batch_bytes' are collected, like Nagle's algorithm does.
+    std::chrono::microseconds delay{0};
+    std::size_t batch_bytes = 64 * 1024;
+};
+
+// Concurrent callers share one connection. Their commands are corked
+// while the previous write is in progress and written at once, the replies
+// are read by a reader thread. The number of commands in flight adapts
+// to the observed round trip time and the size of the replies: it grows
+// while the round trip time stays close to the lowest observed one and
+// shrinks when the commands start to queue up on the server.
+class auto_pipeline final
+{
+public:
+    // The reader thread uses only the get area of the stream buffer and
+    // the writer only its put area, so the stream buffer has to keep them
+    // independent, as the ones of the streams created by make_stream do.
+    explicit auto_pipeline(std::shared_ptr<std::iostream> stream,
+            auto_pipeline_options const &options = {})
+        : stream_{std::move(stream)}
+        , writer_{stream_->rdbuf()}
+        , input_{*stream_->rdbuf()}
+        , reader_stream_{&input_}
+        , cork_stream_{&cork_}
+        , options_{options}
+        , depth_{std::max<std::size_t>(options_.min_depth, 1)}
+    {
+        options_.min_depth = depth_;
+        options_.max_depth = std::max(options_.max_depth, depth_);
+        reader_ = std::thread{[this] { read(); }};
+    }
+
+    auto_pipeline(auto_pipeline const &) = delete;
+    auto_pipeline& operator = (auto_pipeline const &) = delete;
+
+    // All the calls have to be completed.
+    ~auto_pipeline() noexcept
+    {
+        {
+            std::lock_guard<std::mutex> lock{mutex_};
+            stopped_ = true;
+        }
+        has_calls_.notify_all();
+        if (reader_.joinable())
+            reader_.join();
+    }
+
+    template <typename ... TArgs>
+    [[nodiscard]]
+    value execute(std::string_view name, TArgs && ... args)
+    {
+        return try_execute(std::move(name), std::forward<TArgs>(args) ... ).value();
+    }
+
+    template <typename ... TArgs>
+    [[nodiscard]]
+    result<value> try_execute(std::string_view name, TArgs && ... args)
+    {
+        return call<value>(std::move(name), std::forward<TArgs>(args) ... );
+    }
+
+    template <typename T, typename ... TArgs>
+    [[nodiscard]]
+    T execute_as(std::string_view name, TArgs && ... args)
+    {
+        return try_execute_as<T>(std::move(name), std::forward<TArgs>(args) ... ).value();
+    }
+
+    template <typename T, typename ... TArgs>
+    [[nodiscard]]
+    result<T> try_execute_as(std::string_view name, TArgs && ... args)
+    {
+        return call<T>(std::move(name), std::forward<TArgs>(args) ... );
+    }
+
+    // The current limit of the commands in flight.
+    [[nodiscard]]
+    std::size_t depth() const
+    {
+        std::lock_guard<std::mutex> lock{mutex_};
+        return depth_;
+    }
+
+private:
+    // Commands are serialized into a string which is swapped
+    // with the one being written, so the buffers are reused.
+    class string_streambuf final
+        : public std::streambuf
+    {
+    public:
+        std::string& data() noexcept
+        {
+            return data_;
+        }
+
+    protected:
+        int_type overflow(int_type c) override
+        {
+            if (!traits_type::eq_int_type(c, traits_type::eof()))
+                data_.push_back(traits_type::to_char_type(c));
+            return traits_type::not_eof(c);
+        }
+
+        std::streamsize xsputn(char_type const *s, std::streamsize n) override
+        {
+            data_.append(s, static_cast<std::size_t>(n));
+            return n;
+        }
+
+    private:
+        std::string data_;
+    };
+
+    // Counts the bytes read from another stream buffer.
+    class counting_streambuf final
+        : public std::streambuf
+    {
+    public:
+        explicit counting_streambuf(std::streambuf &source)
+            : source_{source}
+        {
+            setg(buffer_, buffer_, buffer_);
+        }
+
+        [[nodiscard]]
+        std::uint64_t count() const noexcept
+        {
+            return count_ - static_cast<std::uint64_t>(egptr() - gptr());
+        }
+
+        // Returns true if there is received data which isn't read yet.
+        // Only the get area of the source is looked at.
+        [[nodiscard]]
+        bool buffered()
+        {
+            return gptr() < egptr() || source_.in_avail() > 0;
+        }
+
+    protected:
+        int_type underflow() override
+        {
+            if (gptr() < egptr())
+                return traits_type::to_int_type(*gptr());
+
+            // Waits for the data and takes what is already received.
+            if (traits_type::eq_int_type(source_.sgetc(), traits_type::eof()))
+                return traits_type::eof();
+            auto const available = std::max<std::streamsize>(source_.in_avail(), 1);
+            auto const size = source_.sgetn(buffer_,
+                    std::min<std::streamsize>(available, sizeof(buffer_)));
+            if (size <= 0)
+                return traits_type::eof();
+
+            count_ += static_cast<std::uint64_t>(size);
+            setg(buffer_, buffer_, buffer_ + size);
+            return traits_type::to_int_type(*gptr());
+        }
+
+    private:
+        std::streambuf &source_;
+        char buffer_[16 * 1024];
+        std::uint64_t count_ = 0;
+    };
+
+    struct pending_call final
+    {
+        // Returns false if the stream can't be read anymore.
+        bool (*decode)(std::istream &, void *) = nullptr;
+        void *result = nullptr;
+        bool done = false;
+    };
+
+    struct write_record final
+    {
+        std::uint64_t last_call;
+        std::chrono::steady_clock::time_point time;
+    };
+
+    std::shared_ptr<std::iostream> stream_;
+    std::ostream writer_;
+    counting_streambuf input_;
+    std::istream reader_stream_;
+    string_streambuf cork_;
+    std::ostream cork_stream_;
+    std::string output_;
+    auto_pipeline_options options_;
+
+    mutable std::mutex mutex_;
+    std::condition_variable has_calls_;
+    std::condition_variable completed_;
+    std::condition_variable has_room_;
+    std::condition_variable corked_;
+    std::deque<pending_call *> calls_;
+    pending_call *reading_ = nullptr;
+    std::deque<write_record> writes_;
+    std::uint64_t next_call_ = 0;
+    std::uint64_t completed_calls_ = 0;
+    std::size_t depth_;
+    bool writing_ = false;
+    bool broken_ = false;
+    bool stopped_ = false;
+
+    std::chrono::steady_clock::duration min_rtt_{};
+    double reply_size_ = 0;
+
+    std::thread reader_;
+
+    template <typename T>
+    static bool decode(std::istream &stream, void *result)
+    {
+        auto &res = *static_cast<std::optional<rediscpp::result<T>> *>(result);
+        if constexpr (std::is_same_v<T, value>)
+            res.emplace(value::try_read(stream));
+        else
+            res.emplace(resp::decoding::try_decode<T>(stream));
+        return stream && res->code() != errc::bad_format;
+    }
+
+    template <typename T, typename ... TArgs>
+    result<T> call(std::string_view name, TArgs && ... args)
+    {
+        std::optional<result<T>> res;
+        pending_call pending;
+        pending.decode = &auto_pipeline::decode<T>;
+        pending.result = &res;
+
+        std::unique_lock<std::mutex> lock{mutex_};
+        has_room_.wait(lock, [this] { return std::size(calls_) < depth_ || broken_; });
+        if (broken_)
+            return errc::io_error;
+
+        execute_no_flush(cork_stream_, std::move(name), std::forward<TArgs>(args) ... );
+        calls_.push_back(&pending);
+        ++next_call_;
+        if (std::size(calls_) == 1)
+            has_calls_.notify_one();
+
+        if (!writing_)
+            write(lock);
+        else if (std::size(cork_.data()) >= options_.batch_bytes)
+            corked_.notify_one();
+
+        completed_.wait(lock, [&pending] { return pending.done; });
+        lock.unlock();
+
+        if (!res)
+            return errc::io_error;
+        return std::move(*res);
+    }
+
+    // The caller becomes the writer until there is nothing corked.
+    void write(std::unique_lock<std::mutex> &lock)
+    {
+        writing_ = true;
+
+        if (options_.delay.count() > 0)
+        {
+            corked_.wait_for(lock, options_.delay, [this]
+                    { return std::size(cork_.data()) >= options_.batch_bytes; });
+        }
+
+        while (!cork_.data().empty() && !broken_)
+        {
+            std::swap(output_, cork_.data());
+            writes_.push_back({next_call_, std::chrono::steady_clock::now()});
+
+            lock.unlock();
+            writer_.write(std::data(output_), static_cast<std::streamsize>(std::size(output_)));
+            std::flush(writer_);
+            auto const failed = !writer_;
+            output_.clear();
+            lock.lock();
+
+            if (failed)
+                fail(lock);
+        }
+
+        writing_ = false;
+    }
+
+    void read()
+    {
+        std::unique_lock<std::mutex> lock{mutex_};
+        for (;;)
+        {
+            has_calls_.wait(lock, [this] { return !calls_.empty() || stopped_; });
+            if (calls_.empty())
+                return;
+
+            auto *pending = calls_.front();
+            reading_ = pending;
+            lock.unlock();
+
+            auto const start = input_.count();
+            auto const failed = !pending->decode(reader_stream_, pending->result);
+            auto const size = input_.count() - start;
+            // The callers are woken up when there is no more received data.
+            auto const notify = failed || !input_.buffered();
+
+            lock.lock();
+            calls_.pop_front();
+            reading_ = nullptr;
+            pending->done = true;
+            ++completed_calls_;
+            adapt(static_cast<double>(size));
+            has_room_.notify_all();
+
+            if (failed)
+                fail(lock);
+            if (notify || calls_.empty())
+                completed_.notify_all();
+        }
+    }
+
+    void adapt(double reply_size)
+    {
+        reply_size_ = reply_size_ > 0 ? reply_size_ + (reply_size - reply_size_) / 16 : reply_size;
+
+        if (writes_.empty() || completed_calls_ < writes_.front().last_call)
+            return;
+
+        auto const rtt = std::chrono::steady_clock::now() - writes_.front().time;
+        writes_.pop_front();
+
+        // The lowest round trip time slowly goes up, so it follows
+        // the changes of the network.
+        if (min_rtt_.count() == 0 || rtt < min_rtt_)
+            min_rtt_ = rtt;
+        else
+            min_rtt_ += (rtt - min_rtt_) / 64;
+
+        if (rtt > 2 * min_rtt_)
+            depth_ -= depth_ / 4;
+        else if (std::size(calls_) + 1 >= depth_)
+            depth_ += depth_ / 8 + 1;
+
+        auto const by_size = static_cast<std::size_t>(
+                static_cast<double>(options_.max_reply_bytes) / std::max(reply_size_, 1.0));
+        depth_ = std::clamp(std::min(depth_, by_size), options_.min_depth, options_.max_depth);
+    }
+
+    // The calls are completed with an error, the connection can't be used anymore.
+    // The call which is being read is completed by the reader.
+    void fail(std::unique_lock<std::mutex> &)
+    {
+        broken_ = true;
+        auto const keep = !calls_.empty() && calls_.front() == reading_;
+        for (auto iter = std::begin(calls_) + (keep ? 1 : 0) ; iter != std::end(calls_) ; ++iter)
+            (*iter)->done = true;
+        calls_.erase(std::begin(calls_) + (keep ? 1 : 0), std::end(calls_));
+        completed_.notify_all();
+        has_room_.notify_all();
+    }
+};
+
+}   // namespace rediscpp
+
+#endif  // !REDISCPP_AUTO_PIPELINE_H_
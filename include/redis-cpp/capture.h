@@ -0,0 +1,494 @@
+//-------------------------------------------------------------------
+//  redis-cpp
+//  https://github.com/tdv/redis-cpp
+//  Created:     10.2026
+//  Copyright 2020 Dmitry Tkachenko (tkachenkodmitryv@gmail.com)
+//  Distributed under the MIT License
+//  (See accompanying file LICENSE)
+//-------------------------------------------------------------------
+
+#ifndef REDISCPP_CAPTURE_H_
+#define REDISCPP_CAPTURE_H_
+
+#ifndef REDISCPP_PURE_CORE
+
+// STD
+#include <algorithm>
+#include <atomic>
+#include <charconv>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+// REDIS-CPP
+#include <redis-cpp/detail/config.h>
+// The header-only transport goes before the RESP headers.
+#include <redis-cpp/stream.h>
+#include <redis-cpp/error.h>
+#include <redis-cpp/resp/decoding.h>
+#include <redis-cpp/tap.h>
+
+namespace rediscpp
+{
+
+enum class capture_direction : std::uint8_t
+{
+    sent = 0,
+    received = 1
+};
+
+// Writes the traffic of the streams made by record_stream into a file:
+// the signature, then for each piece of data its direction (u8) and varints
+// of the connection, the microseconds since the previous record and
+// the size, then the bytes as they're sent or received. It's thread-safe.
+class traffic_recorder final
+{
+public:
+    static constexpr std::string_view signature = "RCPPCAP1";
+
+    explicit traffic_recorder(std::ostream &file)
+        : file_{file}
+    {
+        file_.write(std::data(signature), static_cast<std::streamsize>(std::size(signature)));
+    }
+
+    traffic_recorder(traffic_recorder const &) = delete;
+    traffic_recorder& operator = (traffic_recorder const &) = delete;
+
+    // A new connection id.
+    [[nodiscard]]
+    std::uint64_t add_connection() noexcept
+    {
+        return connections_++;
+    }
+
+    void write(capture_direction direction, std::uint64_t connection, char const *data, std::size_t size)
+    {
+        std::lock_guard<std::mutex> lock{mutex_};
+        auto const now = static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(
+                std::chrono::steady_clock::now() - start_).count());
+        file_.put(static_cast<char>(direction));
+        put(connection);
+        put(now - last_);
+        put(size);
+        file_.write(data, static_cast<std::streamsize>(size));
+        last_ = now;
+    }
+
+    void flush()
+    {
+        std::lock_guard<std::mutex> lock{mutex_};
+        std::flush(file_);
+    }
+
+private:
+    std::ostream &file_;
+    std::atomic<std::uint64_t> connections_{0};
+    std::mutex mutex_;
+    std::chrono::steady_clock::time_point const start_ = std::chrono::steady_clock::now();
+    std::uint64_t last_ = 0;
+
+    void put(std::uint64_t number)
+    {
+        do
+        {
+            auto byte = static_cast<std::uint8_t>(number & 0x7F);
+            number >>= 7;
+            if (number)
+                byte |= 0x80;
+            file_.put(static_cast<char>(byte));
+        }
+        while (number);
+    }
+};
+
+// The observer of tapped_stream which writes the data into the recorder.
+class traffic_tap final
+{
+public:
+    explicit traffic_tap(std::shared_ptr<traffic_recorder> recorder)
+        : recorder_{std::move(recorder)}
+        , connection_{recorder_->add_connection()}
+    {
+    }
+
+    void sent(char const *data, std::size_t size)
+    {
+        recorder_->write(capture_direction::sent, connection_, data, size);
+    }
+
+    void received(char const *data, std::size_t size)
+    {
+        recorder_->write(capture_direction::received, connection_, data, size);
+    }
+
+private:
+    std::shared_ptr<traffic_recorder> recorder_;
+    std::uint64_t const connection_;
+};
+
+// Wraps the stream so its traffic is recorded, e.g. with execute, pipelines
+// or auto_pipeline. The handshake of make_stream has been done already,
+// so it isn't recorded.
+[[nodiscard]]
+inline std::shared_ptr<std::iostream> record_stream(std::shared_ptr<std::iostream> stream,
+        std::shared_ptr<traffic_recorder> recorder)
+{
+    return std::make_shared<tapped_stream<traffic_tap>>(std::move(stream), std::move(recorder));
+}
+
+// Reads the records of traffic_recorder one by one, the data is valid
+// until the next record is read.
+class capture_reader final
+{
+public:
+    explicit capture_reader(std::istream &file)
+        : file_{file}
+    {
+        char head[std::size(traffic_recorder::signature)];
+        file_.read(head, static_cast<std::streamsize>(std::size(head)));
+        if (!file_ || std::string_view{head, std::size(head)} != traffic_recorder::signature)
+            error_ = {make_error_code(errc::bad_format), "It's not a capture of rediscpp."};
+    }
+
+    // False at the end of the file or on an error.
+    [[nodiscard]]
+    bool next()
+    {
+        if (error_)
+            return false;
+        auto const direction = file_.get();
+        if (direction == std::istream::traits_type::eof())
+            return false;
+
+        std::uint64_t delta = 0;
+        std::uint64_t size = 0;
+        if ((direction != 0 && direction != 1) || !get(connection_) || !get(delta) || !get(size))
+        {
+            error_ = {make_error_code(errc::bad_format), "The capture is broken."};
+            return false;
+        }
+        data_.resize(static_cast<std::size_t>(size));
+        if (size && !file_.read(std::data(data_), static_cast<std::streamsize>(size)))
+        {
+            error_ = {make_error_code(errc::bad_format), "The capture is truncated."};
+            return false;
+        }
+        direction_ = static_cast<capture_direction>(direction);
+        time_ += std::chrono::microseconds{delta};
+        return true;
+    }
+
+    [[nodiscard]]
+    capture_direction direction() const noexcept
+    {
+        return direction_;
+    }
+
+    [[nodiscard]]
+    std::uint64_t connection() const noexcept
+    {
+        return connection_;
+    }
+
+    // Since the recorder has been made.
+    [[nodiscard]]
+    std::chrono::microseconds time() const noexcept
+    {
+        return time_;
+    }
+
+    [[nodiscard]]
+    std::string_view data() const noexcept
+    {
+        return data_;
+    }
+
+    [[nodiscard]]
+    rediscpp::error const& error() const noexcept
+    {
+        return error_;
+    }
+
+private:
+    std::istream &file_;
+    capture_direction direction_ = capture_direction::sent;
+    std::uint64_t connection_ = 0;
+    std::chrono::microseconds time_{0};
+    std::string data_;
+    rediscpp::error error_;
+
+    bool get(std::uint64_t &number)
+    {
+        number = 0;
+        for (int shift = 0 ; shift < 64 ; shift += 7)
+        {
+            auto const byte = file_.get();
+            if (byte == std::istream::traits_type::eof())
+                return false;
+            number |= static_cast<std::uint64_t>(byte & 0x7F) << shift;
+            if (!(byte & 0x80))
+                return true;
+        }
+        return false;
+    }
+};
+
+struct replay_options final
+{
+    stream_options connection;
+    // 1 keeps the recorded pace, 2 is twice as fast, zero is as fast
+    // as possible.
+    double speed = 1.0;
+    // The connections to the target. The recorded connections are spread
+    // over them, the commands of a recorded connection keep their order.
+    std::size_t concurrency = 1;
+    // The commands in flight per connection.
+    std::size_t window = 1000;
+};
+
+struct replay_stats final
+{
+    std::uint64_t commands = 0;
+    // Error replies.
+    std::uint64_t errors = 0;
+    std::chrono::microseconds duration{0};
+    // From the write of a command to its reply.
+    std::chrono::microseconds p50{0};
+    std::chrono::microseconds p90{0};
+    std::chrono::microseconds p99{0};
+    std::chrono::microseconds p999{0};
+    std::chrono::microseconds max{0};
+};
+
+// Sends the recorded commands to the target again with their recorded
+// timing, scaled by the speed. The replies are read by another thread, so
+// a slow reply doesn't hold the next commands back. The commands which
+// change the protocol, e.g. SUBSCRIBE, can't be replayed.
+[[nodiscard]]
+inline result<replay_stats> replay(std::istream &capture, std::string_view host, std::string_view port,
+        replay_options const &options = {})
+{
+    struct command final
+    {
+        std::chrono::microseconds time;
+        std::size_t offset;
+        std::size_t size;
+    };
+
+    struct worker final
+    {
+        std::string data;
+        std::vector<command> commands;
+        std::vector<std::chrono::microseconds> latencies;
+        std::uint64_t errors = 0;
+        rediscpp::error failure;
+    };
+
+    // The size of the first complete command in the data, zero if it isn't complete.
+    auto const command_size = [] (std::string_view data) -> std::size_t
+    {
+        std::size_t pos = 0;
+        auto const line = [&data, &pos] (std::int64_t &number)
+        {
+            auto const end = data.find("\r\n", pos);
+            if (end == std::string_view::npos || end == pos)
+                return false;
+            number = 0;
+            std::from_chars(std::data(data) + pos + 1, std::data(data) + end, number);
+            pos = end + 2;
+            return true;
+        };
+
+        std::int64_t args = 0;
+        if (!line(args) || data[0] != '*')
+            return 0;
+        for (std::int64_t i = 0 ; i < args ; ++i)
+        {
+            std::int64_t length = 0;
+            if (!line(length))
+                return 0;
+            pos += static_cast<std::size_t>(std::max<std::int64_t>(length, 0)) + 2;
+            if (pos > std::size(data))
+                return 0;
+        }
+        return pos;
+    };
+
+    capture_reader reader{capture};
+    auto const concurrency = std::max<std::size_t>(options.concurrency, 1);
+    auto const window = std::max<std::size_t>(options.window, 1);
+    std::vector<worker> workers(concurrency);
+    std::unordered_map<std::uint64_t, std::string> partial;
+    while (reader.next())
+    {
+        if (reader.direction() != capture_direction::sent)
+            continue;
+        auto &rest = partial[reader.connection()];
+        rest.append(reader.data());
+        auto &target = workers[reader.connection() % concurrency];
+        std::string_view data{rest};
+        while (auto const size = command_size(data))
+        {
+            target.commands.push_back({reader.time(), std::size(target.data), size});
+            target.data.append(data.substr(0, size));
+            data.remove_prefix(size);
+        }
+        rest.erase(0, std::size(rest) - std::size(data));
+    }
+    if (reader.error())
+        return reader.error();
+
+    auto const start = std::chrono::steady_clock::now();
+    auto const first = [&workers]
+    {
+        auto res = std::chrono::microseconds::max();
+        for (auto const &item : workers)
+        {
+            if (!item.commands.empty())
+                res = std::min(res, item.commands.front().time);
+        }
+        return res;
+    }();
+
+    auto const run = [&] (worker &item)
+    {
+        std::error_code ec;
+        auto stream = make_stream(host, port, options.connection, ec);
+        if (!stream)
+        {
+            item.failure = rediscpp::error{ec, "The target isn't available."};
+            return;
+        }
+
+        std::mutex mutex;
+        std::condition_variable has_room;
+        std::deque<std::chrono::steady_clock::time_point> sent;
+        bool broken = false;
+
+        std::thread replies{[&]
+            {
+                std::istream input{stream->rdbuf()};
+                for (std::size_t i = 0 ; i < std::size(item.commands) ; ++i)
+                {
+                    resp::decoding::header hdr;
+                    rediscpp::error err;
+                    if (!hdr.read(input, err) || !resp::detail::decoding::skip(input, hdr, err))
+                    {
+                        std::lock_guard<std::mutex> lock{mutex};
+                        item.failure = err ? err : rediscpp::error{make_error_code(errc::io_error)};
+                        broken = true;
+                        has_room.notify_one();
+                        return;
+                    }
+                    auto const now = std::chrono::steady_clock::now();
+                    item.errors += hdr.mark() == resp::detail::marker::error_message;
+
+                    std::lock_guard<std::mutex> lock{mutex};
+                    item.latencies.push_back(std::chrono::duration_cast<std::chrono::microseconds>(
+                            now - sent.front()));
+                    sent.pop_front();
+                    has_room.notify_one();
+                }
+            }
+        };
+
+        std::ostream output{stream->rdbuf()};
+        // At full speed the commands are flushed in batches.
+        std::size_t corked = 0;
+        for (auto const &cmd : item.commands)
+        {
+            auto const paced = options.speed > 0;
+            if (paced)
+            {
+                auto const delay = std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+                        (cmd.time - first) / options.speed);
+                std::this_thread::sleep_until(start + delay);
+            }
+
+            std::unique_lock<std::mutex> lock{mutex};
+            // The replies can't come until the corked commands are sent.
+            if (std::size(sent) >= window && corked)
+            {
+                lock.unlock();
+                std::flush(output);
+                lock.lock();
+                corked = 0;
+            }
+            has_room.wait(lock, [&] { return std::size(sent) < window || broken; });
+            if (broken)
+                break;
+            sent.push_back(std::chrono::steady_clock::now());
+            lock.unlock();
+
+            output.write(std::data(item.data) + cmd.offset, static_cast<std::streamsize>(cmd.size));
+            if (paced || ++corked == 64)
+            {
+                std::flush(output);
+                corked = 0;
+            }
+        }
+        std::flush(output);
+        if (!output)
+        {
+            std::lock_guard<std::mutex> lock{mutex};
+            if (!broken)
+                item.failure = make_error_code(errc::io_error);
+        }
+        replies.join();
+    };
+
+    std::vector<std::thread> threads;
+    for (auto &item : workers)
+    {
+        if (!item.commands.empty())
+            threads.emplace_back(run, std::ref(item));
+    }
+    for (auto &thread : threads)
+        thread.join();
+
+    replay_stats stats;
+    stats.duration = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start);
+    std::vector<std::chrono::microseconds> latencies;
+    for (auto &item : workers)
+    {
+        if (item.failure)
+            return item.failure;
+        stats.commands += std::size(item.latencies);
+        stats.errors += item.errors;
+        latencies.insert(std::end(latencies), std::begin(item.latencies), std::end(item.latencies));
+    }
+    if (latencies.empty())
+        return stats;
+
+    std::sort(std::begin(latencies), std::end(latencies));
+    auto const percentile = [&latencies] (double rank)
+    {
+        auto const index = static_cast<std::size_t>(rank * static_cast<double>(std::size(latencies)));
+        return latencies[std::min(index, std::size(latencies) - 1)];
+    };
+    stats.p50 = percentile(0.5);
+    stats.p90 = percentile(0.9);
+    stats.p99 = percentile(0.99);
+    stats.p999 = percentile(0.999);
+    stats.max = latencies.back();
+    return stats;
+}
+
+}   // namespace rediscpp
+
+#endif  // !REDISCPP_PURE_CORE
+
+#endif  // !REDISCPP_CAPTURE_H_
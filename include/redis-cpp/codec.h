@@ -0,0 +1,306 @@
+//-------------------------------------------------------------------
+//  redis-cpp
+//  https://github.com/tdv/redis-cpp
+//  Created:     10.2026
+//  Copyright 2020 Dmitry Tkachenko (tkachenkodmitryv@gmail.com)
+//  Distributed under the MIT License
+//  (See accompanying file LICENSE)
+//-------------------------------------------------------------------
+
+#ifndef REDISCPP_CODEC_H_
+#define REDISCPP_CODEC_H_
+
+// STD
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+// REDIS-CPP
+#include <redis-cpp/detail/config.h>
+#include <redis-cpp/error.h>
+
+namespace rediscpp
+{
+
+// A compressor of the LZ4 block format with no dependencies, it's fast
+// and the blocks can be read by any LZ4 decoder. A compressor of value_codec
+// has to provide
+//   static constexpr std::uint8_t id;   // 1 - 255, it's stored in the header
+//   void compress(std::string_view data, std::string &out) const;
+//   bool decompress(std::string_view data, std::size_t size, std::string &out) const;
+// compress appends to `out`, decompress appends exactly `size` bytes
+// or returns false.
+class lz4_compressor final
+{
+public:
+    static constexpr std::uint8_t id = 1;
+
+    void compress(std::string_view data, std::string &out) const
+    {
+        auto const *in = reinterpret_cast<unsigned char const *>(std::data(data));
+        auto const size = std::size(data);
+        std::size_t anchor = 0;
+
+        // A match can't start within the last 12 bytes and the last 5 bytes
+        // are literals, as the format requires.
+        if (size >= min_input)
+        {
+            std::vector<std::uint32_t> table(std::size_t{1} << hash_bits);
+            std::size_t const match_limit = size - 12;
+            std::size_t const end_limit = size - 5;
+            for (std::size_t pos = 0 ; pos < match_limit ; )
+            {
+                auto const sequence = read32(in + pos);
+                auto &slot = table[(sequence * 2654435761u) >> (32 - hash_bits)];
+                auto const candidate = static_cast<std::size_t>(slot);
+                slot = static_cast<std::uint32_t>(pos + 1);
+                if (!candidate || pos - (candidate - 1) > 65535 || read32(in + candidate - 1) != sequence)
+                {
+                    ++pos;
+                    continue;
+                }
+
+                auto const ref = candidate - 1;
+                auto length = std::size_t{4};
+                while (pos + length < end_limit && in[ref + length] == in[pos + length])
+                    ++length;
+                put_sequence(out, in + anchor, pos - anchor, pos - ref, length - 4);
+                pos += length;
+                anchor = pos;
+            }
+        }
+        put_sequence(out, in + anchor, size - anchor, 0, 0);
+    }
+
+    bool decompress(std::string_view data, std::size_t size, std::string &out) const
+    {
+        auto const *in = reinterpret_cast<unsigned char const *>(std::data(data));
+        auto const *const end = in + std::size(data);
+        auto const base = std::size(out);
+        out.resize(base + size);
+        auto *const dst = reinterpret_cast<unsigned char *>(std::data(out)) + base;
+        std::size_t pos = 0;
+
+        while (in < end)
+        {
+            auto const token = *in++;
+            std::size_t literals = token >> 4;
+            if (literals == 15 && !get_length(in, end, literals))
+                return false;
+            if (static_cast<std::size_t>(end - in) < literals || size - pos < literals)
+                return false;
+            std::memcpy(dst + pos, in, literals);
+            in += literals;
+            pos += literals;
+            if (in == end)
+                break;
+
+            if (end - in < 2)
+                return false;
+            auto const offset = static_cast<std::size_t>(in[0]) | (static_cast<std::size_t>(in[1]) << 8);
+            in += 2;
+            std::size_t length = token & 15;
+            if (length == 15 && !get_length(in, end, length))
+                return false;
+            length += 4;
+            if (!offset || offset > pos || size - pos < length)
+                return false;
+            if (offset >= length)
+            {
+                std::memcpy(dst + pos, dst + pos - offset, length);
+                pos += length;
+                continue;
+            }
+            // The match overlaps itself, e.g. a run of one byte.
+            for (std::size_t i = 0 ; i < length ; ++i, ++pos)
+                dst[pos] = dst[pos - offset];
+        }
+        return pos == size;
+    }
+
+private:
+    static constexpr int hash_bits = 12;
+    static constexpr std::size_t min_input = 13;
+
+    static std::uint32_t read32(unsigned char const *data) noexcept
+    {
+        std::uint32_t res;
+        std::memcpy(&res, data, sizeof(res));
+        return res;
+    }
+
+    static void put_length(std::string &out, std::size_t length)
+    {
+        for ( ; length >= 255 ; length -= 255)
+            out.push_back(static_cast<char>(255));
+        out.push_back(static_cast<char>(length));
+    }
+
+    static bool get_length(unsigned char const *&in, unsigned char const *end, std::size_t &length)
+    {
+        for ( ; ; )
+        {
+            if (in == end)
+                return false;
+            auto const byte = *in++;
+            length += byte;
+            if (byte != 255)
+                return true;
+        }
+    }
+
+    // The literals, then the match unless it's the last sequence (no offset).
+    static void put_sequence(std::string &out, unsigned char const *literals, std::size_t count,
+            std::size_t offset, std::size_t length)
+    {
+        out.push_back(static_cast<char>((std::min<std::size_t>(count, 15) << 4) |
+                (offset ? std::min<std::size_t>(length, 15) : 0)));
+        if (count >= 15)
+            put_length(out, count - 15);
+        out.append(reinterpret_cast<char const *>(literals), count);
+        if (!offset)
+            return;
+        out.push_back(static_cast<char>(offset & 0xFF));
+        out.push_back(static_cast<char>(offset >> 8));
+        if (length >= 15)
+            put_length(out, length - 15);
+    }
+};
+
+// Compresses the values from the threshold size on and puts a header before
+// them: the marker, the id of the compressor and the size as a varint.
+// The smaller values and the ones which don't compress are stored as they
+// are, so the values written without the codec are read as well. A value
+// which starts with the marker is stored with a header of id 0.
+// The values are encoded before a command is written and decoded after
+// the reply is read, e.g. by the thread which makes the call, not by
+// the reader of auto_pipeline.
+template <typename TCompressor = lz4_compressor>
+class value_codec final
+{
+public:
+    static constexpr std::string_view marker{"\0RZ", 3};
+    // The limit of a Redis string, a header with a larger size is broken.
+    static constexpr std::size_t max_size = 512 * 1024 * 1024;
+
+    explicit value_codec(std::size_t threshold = 512, TCompressor compressor = {})
+        : threshold_{threshold}
+        , compressor_{std::move(compressor)}
+    {
+    }
+
+    [[nodiscard]]
+    std::string encode(std::string_view data) const
+    {
+        std::string res;
+        encode(data, res);
+        return res;
+    }
+
+    // Replaces the content of `out`, its memory is reused.
+    void encode(std::string_view data, std::string &out) const
+    {
+        out.clear();
+        if (std::size(data) >= threshold_)
+        {
+            put_header(out, TCompressor::id, std::size(data));
+            auto const header = std::size(out);
+            compressor_.compress(data, out);
+            if (std::size(out) - header < std::size(data))
+                return;
+            out.clear();
+        }
+
+        if (data.substr(0, std::size(marker)) == marker)
+            put_header(out, 0, std::size(data));
+        out.append(data);
+    }
+
+    [[nodiscard]]
+    result<std::string> decode(std::string_view data) const
+    {
+        std::string res;
+        if (auto err = decode(data, res))
+            return err;
+        return res;
+    }
+
+    // Replaces the content of `out`, its memory is reused.
+    [[nodiscard]]
+    error decode(std::string_view data, std::string &out) const
+    {
+        out.clear();
+        if (data.substr(0, std::size(marker)) != marker)
+        {
+            out.append(data);
+            return {};
+        }
+
+        data.remove_prefix(std::size(marker));
+        std::uint8_t id = 0;
+        std::size_t size = 0;
+        if (!get_header(data, id, size))
+            return {make_error_code(errc::bad_format), "The header of the encoded value is broken."};
+        if (id == 0)
+        {
+            if (std::size(data) != size)
+                return {make_error_code(errc::bad_format), "The stored value is truncated."};
+            out.append(data);
+            return {};
+        }
+        if (id != TCompressor::id)
+            return {make_error_code(errc::bad_format), "The value is encoded by another compressor."};
+        if (!compressor_.decompress(data, size, out))
+        {
+            out.clear();
+            return {make_error_code(errc::bad_format), "The compressed value is broken."};
+        }
+        return {};
+    }
+
+private:
+    std::size_t const threshold_;
+    TCompressor const compressor_;
+
+    static void put_header(std::string &out, std::uint8_t id, std::size_t size)
+    {
+        out.append(marker);
+        out.push_back(static_cast<char>(id));
+        do
+        {
+            auto byte = static_cast<std::uint8_t>(size & 0x7F);
+            size >>= 7;
+            if (size)
+                byte |= 0x80;
+            out.push_back(static_cast<char>(byte));
+        }
+        while (size);
+    }
+
+    static bool get_header(std::string_view &data, std::uint8_t &id, std::size_t &size)
+    {
+        if (data.empty())
+            return false;
+        id = static_cast<std::uint8_t>(data[0]);
+        data.remove_prefix(1);
+        size = 0;
+        for (int shift = 0 ; shift < 35 && !data.empty() ; shift += 7)
+        {
+            auto const byte = static_cast<std::uint8_t>(data[0]);
+            data.remove_prefix(1);
+            size |= static_cast<std::size_t>(byte & 0x7F) << shift;
+            if (!(byte & 0x80))
+                return size <= max_size;
+        }
+        return false;
+    }
+};
+
+}   // namespace rediscpp
+
+#endif  // !REDISCPP_CODEC_H_
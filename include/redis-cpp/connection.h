@@ -0,0 +1,349 @@
+//-------------------------------------------------------------------
+//  redis-cpp
+//  https://github.com/tdv/redis-cpp
+//  Created:     10.2026
+//  Copyright 2020 Dmitry Tkachenko (tkachenkodmitryv@gmail.com)
+//  Distributed under the MIT License
+//  (See accompanying file LICENSE)
+//-------------------------------------------------------------------
+
+#ifndef REDISCPP_CONNECTION_H_
+#define REDISCPP_CONNECTION_H_
+
+#ifndef REDISCPP_PURE_CORE
+
+// STD
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <iostream>
+#include <memory>
+#include <optional>
+#include <random>
+#include <streambuf>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <thread>
+#include <utility>
+#include <vector>
+
+// REDIS-CPP
+#include <redis-cpp/detail/config.h>
+// The header-only transport goes before the RESP headers.
+#include <redis-cpp/stream.h>
+#include <redis-cpp/error.h>
+#include <redis-cpp/execute.h>
+#include <redis-cpp/value.h>
+
+namespace rediscpp
+{
+
+struct connection_options final
+{
+    stream_options stream;
+    // The delay before a reconnect is random up to the backoff, which is
+    // doubled after each failed attempt, so the clients which have lost
+    // their connections at once don't come back at once.
+    std::chrono::milliseconds min_backoff{50};
+    std::chrono::milliseconds max_backoff{5000};
+    // Attempts to connect before the queued commands fail, zero is for no limit.
+    std::size_t max_attempts = 10;
+    // Idempotent commands whose replies have been lost are sent again.
+    bool retry_idempotent = true;
+};
+
+// A pipeline which survives a lost connection. The commands are kept
+// until their replies are received. After a reconnect the commands which
+// haven't been written are sent, the written ones fail since they could
+// have been executed, except for the idempotent ones which are sent again.
+// The connection isn't thread-safe, as the streams.
+class connection final
+{
+public:
+    // It connects with the first command.
+    connection(std::string host, std::string port, connection_options const &options = {})
+        : host_{std::move(host)}
+        , port_{std::move(port)}
+        , options_{options}
+        , writer_{&appender_}
+    {
+    }
+
+    connection(connection const &) = delete;
+    connection& operator = (connection const &) = delete;
+
+    // Queues a command, it's written with the next flush or receive.
+    template <typename ... TArgs>
+    void send(std::string_view name, TArgs && ... args)
+    {
+        queue(false, std::move(name), std::forward<TArgs>(args) ... );
+    }
+
+    // E.g. GET, SET without options, HSET, DEL.
+    template <typename ... TArgs>
+    void send_idempotent(std::string_view name, TArgs && ... args)
+    {
+        queue(true, std::move(name), std::forward<TArgs>(args) ... );
+    }
+
+    // Writes the queued commands.
+    void flush()
+    {
+        if (!queue_.empty() && queue_.back().status == state::queued)
+            write();
+    }
+
+    // Returns the reply to the oldest command sent. A server error is
+    // a reply, errc::io_error is for a command which can't be sent or
+    // which may have been executed without a reply.
+    [[nodiscard]]
+    result<value> receive()
+    {
+        while (!queue_.empty())
+        {
+            auto &front = queue_.front();
+            if (front.status == state::failed)
+            {
+                auto err = std::move(front.err);
+                pop();
+                return err;
+            }
+            if (front.status == state::queued)
+            {
+                write();
+                continue;
+            }
+            if (auto reply = read())
+            {
+                pop();
+                return std::move(*reply);
+            }
+            lost();
+        }
+        return rediscpp::error{make_error_code(errc::empty_value), "There are no commands sent."};
+    }
+
+    template <typename ... TArgs>
+    [[nodiscard]]
+    result<value> try_execute(std::string_view name, TArgs && ... args)
+    {
+        send(std::move(name), std::forward<TArgs>(args) ... );
+        return receive();
+    }
+
+    template <typename ... TArgs>
+    [[nodiscard]]
+    value execute(std::string_view name, TArgs && ... args)
+    {
+        return try_execute(std::move(name), std::forward<TArgs>(args) ... ).value();
+    }
+
+    // The number of commands waiting for their replies.
+    [[nodiscard]]
+    std::size_t pending() const noexcept
+    {
+        return std::size(queue_);
+    }
+
+    [[nodiscard]]
+    std::uint64_t reconnects() const noexcept
+    {
+        return reconnects_;
+    }
+
+    // The last error of connecting.
+    [[nodiscard]]
+    std::error_code const& error() const noexcept
+    {
+        return error_;
+    }
+
+private:
+    // Serializes a command into the string of its entry.
+    class appender final
+        : public std::streambuf
+    {
+    public:
+        void target(std::string &data) noexcept
+        {
+            data_ = &data;
+        }
+
+    protected:
+        int_type overflow(int_type c) override
+        {
+            if (!traits_type::eq_int_type(c, traits_type::eof()))
+                data_->push_back(traits_type::to_char_type(c));
+            return traits_type::not_eof(c);
+        }
+
+        std::streamsize xsputn(char_type const *s, std::streamsize n) override
+        {
+            data_->append(s, static_cast<std::size_t>(n));
+            return n;
+        }
+
+    private:
+        std::string *data_ = nullptr;
+    };
+
+    enum class state
+    {
+        queued,
+        written,
+        failed
+    };
+
+    struct entry final
+    {
+        std::string data;
+        bool idempotent = false;
+        state status = state::queued;
+        rediscpp::error err;
+    };
+
+    std::string host_;
+    std::string port_;
+    connection_options options_;
+    std::shared_ptr<std::iostream> stream_;
+    appender appender_;
+    std::ostream writer_;
+    std::deque<entry> queue_;
+    std::vector<std::string> spare_;
+
+    std::size_t failures_ = 0;
+    bool connected_ = false;
+    std::uint64_t reconnects_ = 0;
+    std::error_code error_;
+    std::minstd_rand random_{std::random_device{}()};
+
+    template <typename ... TArgs>
+    void queue(bool idempotent, std::string_view name, TArgs && ... args)
+    {
+        auto &item = queue_.emplace_back();
+        item.idempotent = idempotent;
+        if (!spare_.empty())
+        {
+            item.data = std::move(spare_.back());
+            spare_.pop_back();
+        }
+        appender_.target(item.data);
+        execute_no_flush(writer_, std::move(name), std::forward<TArgs>(args) ... );
+    }
+
+    void pop()
+    {
+        auto &data = queue_.front().data;
+        data.clear();
+        spare_.push_back(std::move(data));
+        queue_.pop_front();
+    }
+
+    // The commands of a failed write may have been received by the server.
+    void write()
+    {
+        if (!connect())
+            return;
+
+        auto &stream = *stream_;
+        for (auto &item : queue_)
+        {
+            if (item.status != state::queued)
+                continue;
+            stream.write(std::data(item.data), static_cast<std::streamsize>(std::size(item.data)));
+            item.status = state::written;
+        }
+        std::flush(stream);
+        if (!stream)
+            lost();
+    }
+
+    // A reply cut off by a lost connection isn't taken, the stream is out
+    // of sync and it has to be made again.
+    std::optional<value> read()
+    {
+        try
+        {
+            if (auto reply = value::try_read(*stream_))
+                return std::move(*reply);
+        }
+        catch (std::exception const &)
+        {
+        }
+        return std::nullopt;
+    }
+
+    void lost()
+    {
+        stream_.reset();
+        failures_ = std::max<std::size_t>(failures_, 1);
+        for (auto &item : queue_)
+        {
+            if (item.status != state::written)
+                continue;
+            if (item.idempotent && options_.retry_idempotent)
+            {
+                item.status = state::queued;
+                continue;
+            }
+            item.status = state::failed;
+            item.err = rediscpp::error{make_error_code(errc::io_error),
+                    "The connection is lost, the command may have been executed."};
+        }
+    }
+
+    // The queued commands fail if there is no connection after all the attempts.
+    bool connect()
+    {
+        if (stream_)
+            return true;
+
+        for (std::size_t attempt = 0 ; !options_.max_attempts || attempt < options_.max_attempts ; ++attempt)
+        {
+            backoff();
+            stream_ = make_stream(host_, port_, options_.stream, error_);
+            if (stream_)
+            {
+                if (connected_)
+                    ++reconnects_;
+                connected_ = true;
+                failures_ = 0;
+                return true;
+            }
+            ++failures_;
+        }
+
+        for (auto &item : queue_)
+        {
+            if (item.status != state::queued)
+                continue;
+            item.status = state::failed;
+            item.err = rediscpp::error{error_, "The command hasn't been sent."};
+        }
+        return false;
+    }
+
+    // "Full jitter": a random delay up to the exponential backoff.
+    void backoff()
+    {
+        if (!failures_)
+            return;
+        auto const shift = std::min<std::size_t>(failures_ - 1, 30);
+        auto const limit = std::min<std::int64_t>(options_.max_backoff.count(),
+                options_.min_backoff.count() << shift);
+        if (limit <= 0)
+            return;
+        auto const delay = std::uniform_int_distribution<std::int64_t>{0, limit}(random_);
+        std::this_thread::sleep_for(std::chrono::milliseconds{delay});
+    }
+};
+
+}   // namespace rediscpp
+
+#endif  // !REDISCPP_PURE_CORE
+
+#endif  // !REDISCPP_CONNECTION_H_
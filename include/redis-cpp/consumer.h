@@ -0,0 +1,422 @@
+//-------------------------------------------------------------------
+//  redis-cpp
+//  https://github.com/tdv/redis-cpp
+//  Created:     10.2026
+//  Copyright 2020 Dmitry Tkachenko (tkachenkodmitryv@gmail.com)
+//  Distributed under the MIT License
+//  (See accompanying file LICENSE)
+//-------------------------------------------------------------------
+
+#ifndef REDISCPP_CONSUMER_H_
+#define REDISCPP_CONSUMER_H_
+
+// STD
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+// REDIS-CPP
+#include <redis-cpp/detail/config.h>
+#include <redis-cpp/error.h>
+#include <redis-cpp/execute.h>
+#include <redis-cpp/resp/decoding.h>
+#include <redis-cpp/resp/serialization.h>
+
+namespace rediscpp
+{
+
+struct stream_entry final
+{
+    std::string id;
+    // Field-value pairs in the order they were added to the stream.
+    std::vector<std::pair<std::string, std::string>> fields;
+};
+
+inline namespace resp
+{
+namespace decoding
+{
+
+// An entry of XRANGE, XREADGROUP, XAUTOCLAIM and so on: [id, [field, value, ...]].
+// The fields of a deleted entry which is still pending in a group are Null,
+// they are decoded as an empty list.
+template <>
+struct decoder<stream_entry>
+{
+    static bool get(std::istream &stream, header &hdr, stream_entry &result, error &err)
+    {
+        if (hdr.mark() != detail::marker::array || hdr.is_null() || hdr.length() != 2)
+            return detail::decoding::unexpected(stream, hdr, err);
+
+        return detail::decoding::for_each_item(stream, hdr.length(), err,
+                [&stream, &result, &err] (header &item, std::size_t index)
+                {
+                    if (index == 0)
+                        return decoding::get(stream, item, result.id, err);
+                    return get_fields(stream, item, result.fields, err);
+                }
+            );
+    }
+
+private:
+    // The strings of the existing fields are reused.
+    static bool get_fields(std::istream &stream, header &hdr,
+            std::vector<std::pair<std::string, std::string>> &fields, error &err)
+    {
+        if (hdr.mark() == detail::marker::array && hdr.is_null())
+        {
+            fields.clear();
+            return true;
+        }
+
+        if (hdr.mark() != detail::marker::array || hdr.length() % 2)
+            return detail::decoding::unexpected(stream, hdr, err);
+
+        fields.resize(static_cast<std::size_t>(hdr.length() / 2));
+        return detail::decoding::for_each_item(stream, hdr.length(), err,
+                [&stream, &fields, &err] (header &item, std::size_t index)
+                {
+                    auto &field = fields[index / 2];
+                    return decoding::get(stream, item,
+                            index % 2 ? field.second : field.first, err);
+                }
+            );
+    }
+};
+
+}   // namespace decoding
+}   // namespace resp
+
+struct consumer_options final
+{
+    // COUNT of XREADGROUP and XAUTOCLAIM.
+    std::size_t count = 100;
+    // BLOCK of XREADGROUP, zero is for a non-blocking read.
+    std::chrono::milliseconds block{1000};
+    // Entries pending for longer are claimed from other consumers
+    // with XAUTOCLAIM (Redis 6.2 or higher). Zero disables claiming.
+    std::chrono::milliseconds min_idle{0};
+    // How often the pending entries are checked.
+    std::chrono::milliseconds claim_interval{5000};
+    // Creates the group and the stream if they don't exist.
+    // The group reads the entries added after its creation.
+    bool create_group = true;
+};
+
+// A consumer of a group. It owns its stream, so several consumers
+// in a process (one per thread) have their own connections.
+class consumer final
+{
+public:
+    // The first entries of the batch of the consumer. The rest of the batch
+    // is kept with its strings for the next reads.
+    class entries final
+    {
+    public:
+        using const_iterator = std::vector<stream_entry>::const_iterator;
+
+        entries(std::vector<stream_entry> const &batch, std::size_t size) noexcept
+            : begin_{std::begin(batch)}
+            , size_{size}
+        {
+        }
+
+        [[nodiscard]]
+        const_iterator begin() const noexcept
+        {
+            return begin_;
+        }
+
+        [[nodiscard]]
+        const_iterator end() const noexcept
+        {
+            return begin_ + static_cast<std::ptrdiff_t>(size_);
+        }
+
+        [[nodiscard]]
+        std::size_t size() const noexcept
+        {
+            return size_;
+        }
+
+        [[nodiscard]]
+        bool empty() const noexcept
+        {
+            return !size_;
+        }
+
+        [[nodiscard]]
+        stream_entry const& operator [] (std::size_t index) const noexcept
+        {
+            return begin_[static_cast<std::ptrdiff_t>(index)];
+        }
+
+    private:
+        const_iterator begin_;
+        std::size_t size_;
+    };
+
+    consumer(std::shared_ptr<std::iostream> stream, std::string key,
+            std::string group, std::string name, consumer_options const &options = {})
+        : stream_{std::move(stream)}
+        , key_{std::move(key)}
+        , group_{std::move(group)}
+        , name_{std::move(name)}
+        , options_{options}
+        , count_{std::to_string(options_.count)}
+        , block_{std::to_string(options_.block.count())}
+        , min_idle_{std::to_string(options_.min_idle.count())}
+    {
+        if (!options_.create_group)
+            return;
+
+        auto reply = try_execute_as<std::string>(*stream_, "xgroup", "create",
+                key_, group_, "$", "mkstream");
+        if (!reply && reply.error().message().substr(0, 9) != "BUSYGROUP")
+            reply.error().raise();
+    }
+
+    consumer(consumer const &) = delete;
+    consumer& operator = (consumer const &) = delete;
+
+    ~consumer() noexcept
+    {
+        try
+        {
+            flush();
+        }
+        catch (...)
+        {
+        }
+    }
+
+    // The acknowledgement is sent with the next read or flush.
+    void ack(std::string_view id)
+    {
+        acks_.emplace_back(id);
+    }
+
+    // Returns the next batch of entries, it's valid until the next read.
+    // Idle pending entries of the group are claimed first. The queued
+    // acknowledgements, XAUTOCLAIM and XREADGROUP take a single round trip.
+    // An empty batch means that there are no entries within the BLOCK time.
+    [[nodiscard]]
+    entries read()
+    {
+        auto &stream = *stream_;
+
+        auto const now = std::chrono::steady_clock::now();
+        auto const claim = options_.min_idle.count() > 0 && now >= next_claim_;
+        if (claim)
+            next_claim_ = now + options_.claim_interval;
+
+        auto const acks = put_acks(stream);
+        if (claim)
+        {
+            execute_no_flush(stream, "xautoclaim", key_, group_, name_,
+                    min_idle_, claim_cursor_, "count", count_);
+        }
+        // The claimed entries are returned at once, so the read doesn't block.
+        if (claim || !options_.block.count())
+        {
+            execute_no_flush(stream, "xreadgroup", "group", group_, name_,
+                    "count", count_, "streams", key_, ">");
+        }
+        else
+        {
+            execute_no_flush(stream, "xreadgroup", "group", group_, name_,
+                    "count", count_, "block", block_, "streams", key_, ">");
+        }
+        std::flush(stream);
+
+        size_ = 0;
+        error err;
+        if ((!acks || read_acked(stream, err)) &&
+                (!claim || read_claimed(stream, err)))
+        {
+            read_new(stream, err);
+        }
+
+        if (err)
+            err.raise();
+
+        return {batch_, size_};
+    }
+
+    // Sends the queued acknowledgements.
+    void flush()
+    {
+        auto &stream = *stream_;
+        if (!put_acks(stream))
+            return;
+        std::flush(stream);
+
+        error err;
+        read_acked(stream, err);
+        if (err)
+            err.raise();
+    }
+
+    // Calls the handler for each entry until 'stopped' is set.
+    // An entry is acknowledged if the handler returns true.
+    template <typename THandler>
+    void run(THandler handler, std::atomic<bool> const &stopped)
+    {
+        while (!stopped.load(std::memory_order_acquire))
+        {
+            for (auto const &entry : read())
+            {
+                if (handler(entry))
+                    ack(entry.id);
+            }
+        }
+        flush();
+    }
+
+private:
+    std::shared_ptr<std::iostream> stream_;
+    std::string key_;
+    std::string group_;
+    std::string name_;
+    consumer_options options_;
+
+    std::string count_;
+    std::string block_;
+    std::string min_idle_;
+    std::string claim_cursor_ = "0-0";
+    std::chrono::steady_clock::time_point next_claim_;
+
+    std::vector<std::string> acks_;
+    std::vector<stream_entry> batch_;
+    std::size_t size_ = 0;
+
+    bool put_acks(std::ostream &stream)
+    {
+        if (acks_.empty())
+            return false;
+
+        put(stream, resp::serialization::array_header{std::size(acks_) + 3});
+        put(stream, resp::serialization::bulk_string{"xack"});
+        put(stream, resp::serialization::bulk_string{key_});
+        put(stream, resp::serialization::bulk_string{group_});
+        for (auto const &id : acks_)
+            put(stream, resp::serialization::bulk_string{id});
+        acks_.clear();
+
+        return true;
+    }
+
+    // The first error is kept, the rest of the replies are read
+    // unless the stream is broken.
+    static bool keep(error &err, error reply_err)
+    {
+        auto const fatal = resp::detail::decoding::is_fatal(reply_err);
+        if (!err)
+            err = std::move(reply_err);
+        return !fatal;
+    }
+
+    static bool read_acked(std::istream &stream, error &err)
+    {
+        auto reply = resp::decoding::try_decode<std::int64_t>(stream);
+        return reply || keep(err, reply.error());
+    }
+
+    // [next cursor, [entries], [deleted ids]]
+    bool read_claimed(std::istream &stream, error &err)
+    {
+        error reply_err;
+        resp::decoding::header hdr;
+        if (hdr.read(stream, reply_err))
+        {
+            if (hdr.mark() != resp::detail::marker::array || hdr.is_null() || hdr.length() < 2)
+            {
+                resp::detail::decoding::unexpected(stream, hdr, reply_err);
+            }
+            else
+            {
+                resp::detail::decoding::for_each_item(stream, hdr.length(), reply_err,
+                        [this, &stream, &reply_err] (resp::decoding::header &item, std::size_t index)
+                        {
+                            if (index == 0)
+                                return resp::decoding::get(stream, item, claim_cursor_, reply_err);
+                            if (index == 1)
+                                return read_entries(stream, item, reply_err);
+                            return resp::detail::decoding::skip(stream, item, reply_err);
+                        }
+                    );
+            }
+        }
+        return !reply_err || keep(err, std::move(reply_err));
+    }
+
+    // [[key, [entries]]] or Null if there are no entries within the BLOCK time.
+    bool read_new(std::istream &stream, error &err)
+    {
+        error reply_err;
+        resp::decoding::header hdr;
+        if (hdr.read(stream, reply_err) && !(hdr.mark() == resp::detail::marker::array && hdr.is_null()))
+        {
+            if (hdr.mark() != resp::detail::marker::array)
+            {
+                resp::detail::decoding::unexpected(stream, hdr, reply_err);
+            }
+            else
+            {
+                resp::detail::decoding::for_each_item(stream, hdr.length(), reply_err,
+                        [this, &stream, &reply_err] (resp::decoding::header &item, std::size_t)
+                        {
+                            if (item.mark() != resp::detail::marker::array || item.length() != 2)
+                                return resp::detail::decoding::unexpected(stream, item, reply_err);
+                            return resp::detail::decoding::for_each_item(stream, item.length(), reply_err,
+                                    [this, &stream, &reply_err] (resp::decoding::header &sub, std::size_t index)
+                                    {
+                                        return index == 0 ?
+                                                resp::detail::decoding::skip(stream, sub, reply_err) :
+                                                read_entries(stream, sub, reply_err);
+                                    }
+                                );
+                        }
+                    );
+            }
+        }
+        return !reply_err || keep(err, std::move(reply_err));
+    }
+
+    // The entries are decoded into the batch reusing its strings.
+    // Deleted entries are acknowledged and aren't returned.
+    bool read_entries(std::istream &stream, resp::decoding::header &hdr, error &err)
+    {
+        if (hdr.mark() != resp::detail::marker::array || hdr.is_null())
+            return resp::detail::decoding::unexpected(stream, hdr, err);
+
+        return resp::detail::decoding::for_each_item(stream, hdr.length(), err,
+                [this, &stream, &err] (resp::decoding::header &item, std::size_t)
+                {
+                    if (item.mark() == resp::detail::marker::array && item.is_null())
+                        return true;
+                    if (size_ == std::size(batch_))
+                        batch_.emplace_back();
+                    auto &entry = batch_[size_];
+                    if (!resp::decoding::get(stream, item, entry, err))
+                        return false;
+                    if (entry.fields.empty())
+                        acks_.push_back(entry.id);
+                    else
+                        ++size_;
+                    return true;
+                }
+            );
+    }
+};
+
+}   // namespace rediscpp
+
+#endif  // !REDISCPP_CONSUMER_H_
@@ -0,0 +1,90 @@
+//-------------------------------------------------------------------
+//  redis-cpp
+//  https://github.com/tdv/redis-cpp
+//  Created:     10.2026
+//  Copyright 2020 Dmitry Tkachenko (tkachenkodmitryv@gmail.com)
+//  Distributed under the MIT License
+//  (See accompanying file LICENSE)
+//-------------------------------------------------------------------
+
+#ifndef REDISCPP_DETAIL_DEADLINE_HPP_
+#define REDISCPP_DETAIL_DEADLINE_HPP_
+
+// STD
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <climits>
+
+namespace rediscpp
+{
+namespace detail
+{
+
+// Deadlines of the operations on a stream. An operation has to be completed
+// by the deadline of the stream (set_deadline) and within the timeout
+// of the connection. Once a deadline is missed the stream is expired:
+// a late reply must not be taken for the reply to a next command,
+// so the stream fails all the next operations.
+// The reader and the writer of the stream may be different threads and
+// the deadline may be changed by another one, so the state is atomic.
+class deadline final
+{
+public:
+    using clock = std::chrono::steady_clock;
+
+    static constexpr clock::time_point none = clock::time_point::max();
+
+    // The deadline of an operation started now.
+    [[nodiscard]]
+    clock::time_point next() const noexcept
+    {
+        auto const at = clock::time_point{clock::duration{at_.load(std::memory_order_relaxed)}};
+        auto const timeout = clock::duration{timeout_.load(std::memory_order_relaxed)};
+        if (timeout.count() <= 0)
+            return at;
+        return std::min(at, clock::now() + timeout);
+    }
+
+    // A timeout of poll: -1 is for none, 0 if the deadline has passed.
+    [[nodiscard]]
+    static int milliseconds_left(clock::time_point until) noexcept
+    {
+        if (until == none)
+            return -1;
+        auto const left = std::chrono::ceil<std::chrono::milliseconds>(until - clock::now()).count();
+        return static_cast<int>(std::clamp<decltype(left)>(left, 0, INT_MAX));
+    }
+
+    // An operation which is already waiting keeps its deadline.
+    void set(clock::time_point at) noexcept
+    {
+        at_.store(at.time_since_epoch().count(), std::memory_order_relaxed);
+    }
+
+    void set_timeout(clock::duration timeout) noexcept
+    {
+        timeout_.store(timeout.count(), std::memory_order_relaxed);
+    }
+
+    void expire() noexcept
+    {
+        expired_.store(true, std::memory_order_release);
+    }
+
+    [[nodiscard]]
+    bool expired() const noexcept
+    {
+        return expired_.load(std::memory_order_acquire);
+    }
+
+private:
+    std::atomic<clock::rep> at_{none.time_since_epoch().count()};
+    std::atomic<clock::rep> timeout_{0};
+    std::atomic<bool> expired_{false};
+};
+
+}   // namespace detail
+}   // namespace rediscpp
+
+#endif  // !REDISCPP_DETAIL_DEADLINE_HPP_
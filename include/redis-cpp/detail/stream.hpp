@@ -10,93 +10,436 @@
 #ifndef REDISCPP_PURE_CORE
 
 // STD
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <climits>
+#include <initializer_list>
+#include <istream>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <ostream>
 #include <stdexcept>
+#include <streambuf>
+#include <string>
+#include <string_view>
+#include <system_error>
 #include <utility>
+#include <vector>
+
+#ifndef BOOST_ASIO_WINDOWS
+#include <poll.h>
+#include <sys/socket.h>
+#endif  // !BOOST_ASIO_WINDOWS
+
+#ifdef __linux__
+// LINUX
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <pthread.h>
+#include <sched.h>
+#include <sys/socket.h>
+#endif  // !__linux__
 
 // BOOST
 #include <boost/asio.hpp>
-#include <boost/iostreams/categories.hpp>
-#include <boost/iostreams/stream.hpp>
+
+// REDIS-CPP
+#include <redis-cpp/detail/deadline.hpp>
+#include <redis-cpp/detail/uring.hpp>
+#include <redis-cpp/error.h>
+#include <redis-cpp/tap.h>
 
 namespace rediscpp
 {
 namespace detail
 {
 
-class tcp_stream_device final
+// The stream buffer reads and writes the socket with recv and send.
+// The get area is used by the reader and the put area by the writer only,
+// so one thread can read while another one writes without a lock.
+// The socket stays blocking, an operation with a deadline doesn't wait
+// in the call but polls the socket until the deadline.
+// A transport error is thrown, the stream catches it and becomes bad.
+class socket_streambuf final
+    : public std::streambuf
 {
 public:
-    using char_type = char;
-    using category = boost::iostreams::bidirectional_device_tag;
+    using native_handle_type = boost::asio::generic::stream_protocol::socket::native_handle_type;
+
+    static constexpr std::size_t default_buffer_size = 4096;
 
-    tcp_stream_device(boost::asio::ip::tcp::socket &socket)
+    socket_streambuf(native_handle_type socket, detail::deadline &deadline,
+            std::size_t read_buffer_size, std::size_t write_buffer_size)
         : socket_{socket}
+        , deadline_{deadline}
+        , read_buffer_(read_buffer_size ? read_buffer_size : default_buffer_size)
+        , write_buffer_(write_buffer_size ? write_buffer_size : default_buffer_size)
     {
+        setg(std::data(read_buffer_), std::data(read_buffer_), std::data(read_buffer_));
+        setp(std::data(write_buffer_), std::data(write_buffer_) + std::size(write_buffer_));
+    }
+
+    ~socket_streambuf() noexcept override
+    {
+        try
+        {
+            if (pptr() != pbase() && !deadline_.expired())
+                send_buffer();
+        }
+        catch (...)
+        {
+        }
     }
 
     [[nodiscard]]
-    std::streamsize read(char *s, std::streamsize n)
+    std::error_code error() const
     {
-        boost::system::error_code ec;
+        std::lock_guard<std::mutex> lock{mutex_};
+        return error_;
+    }
+
+    [[nodiscard]]
+    native_handle_type native_handle() const noexcept
+    {
+        return socket_;
+    }
 
-        auto rval = socket_.read_some(boost::asio::buffer(
-                s, static_cast<std::size_t>(n)), ec);
+protected:
+    int_type underflow() override
+    {
+        if (gptr() < egptr())
+            return traits_type::to_int_type(*gptr());
 
-        if (!ec)
-            return static_cast<std::streamsize>(rval);
-        else if (ec == boost::asio::error::eof)
-            return static_cast<std::streamsize>(-1);
+        auto *data = std::data(read_buffer_);
+        auto const size = receive(data, std::size(read_buffer_));
+        if (!size)
+            return traits_type::eof();
+        setg(data, data, data + size);
+        return traits_type::to_int_type(*gptr());
+    }
+
+    // A large bulk string is read right into the destination.
+    std::streamsize xsgetn(char_type *s, std::streamsize n) override
+    {
+        std::streamsize res = 0;
+        while (res < n)
+        {
+            if (gptr() < egptr())
+            {
+                auto const size = std::min<std::streamsize>(egptr() - gptr(), n - res);
+                traits_type::copy(s + res, gptr(), static_cast<std::size_t>(size));
+                setg(eback(), gptr() + size, egptr());
+                res += size;
+                continue;
+            }
+
+            auto const left = static_cast<std::size_t>(n - res);
+            if (left < std::size(read_buffer_))
+            {
+                if (traits_type::eq_int_type(underflow(), traits_type::eof()))
+                    break;
+                continue;
+            }
+
+            auto const size = receive(s + res, left);
+            if (!size)
+                break;
+            res += static_cast<std::streamsize>(size);
+        }
+        return res;
+    }
+
+    int_type overflow(int_type c) override
+    {
+        send_buffer();
+        if (!traits_type::eq_int_type(c, traits_type::eof()))
+        {
+            *pptr() = traits_type::to_char_type(c);
+            pbump(1);
+        }
+        return traits_type::not_eof(c);
+    }
+
+    // Data which doesn't fit into the buffer isn't copied into it.
+    std::streamsize xsputn(char_type const *s, std::streamsize n) override
+    {
+        auto const size = static_cast<std::size_t>(n);
+        if (size <= static_cast<std::size_t>(epptr() - pptr()))
+        {
+            traits_type::copy(pptr(), s, size);
+            pbump(static_cast<int>(size));
+            return n;
+        }
+
+        send_buffer();
+        if (size < std::size(write_buffer_))
+        {
+            traits_type::copy(pptr(), s, size);
+            pbump(static_cast<int>(size));
+        }
         else
-            throw boost::system::system_error(ec, "read_some");
+        {
+            send(s, size);
+        }
+        return n;
     }
 
-    [[nodiscard]]
-    std::streamsize write(char const *s, std::streamsize n)
+    int sync() override
+    {
+        try
+        {
+            send_buffer();
+            return 0;
+        }
+        catch (boost::system::system_error const &)
+        {
+            return -1;
+        }
+    }
+
+private:
+    native_handle_type socket_;
+    detail::deadline &deadline_;
+
+    std::vector<char> read_buffer_;
+    std::vector<char> write_buffer_;
+
+    // The error is set by both threads.
+    mutable std::mutex mutex_;
+    std::error_code error_;
+
+    void send_buffer()
+    {
+        auto *data = pbase();
+        auto const size = static_cast<std::size_t>(pptr() - pbase());
+        // The data isn't sent again if the send fails.
+        setp(std::data(write_buffer_), std::data(write_buffer_) + std::size(write_buffer_));
+        if (size)
+            send(data, size);
+    }
+
+    // Returns 0 at the end of the stream.
+    std::size_t receive(char *data, std::size_t size)
+    {
+        auto const until = start("read");
+        for (;;)
+        {
+            if (!ready(until, true, "read"))
+                continue;
+            auto const rval = ::recv(socket_, data, chunk(size), flags(until));
+            if (rval >= 0)
+                return static_cast<std::size_t>(rval);
+            check(until, true, "read");
+        }
+    }
+
+    // A short write can't be returned: the stream would keep the rest
+    // of the data and a flush would still succeed.
+    void send(char const *data, std::size_t size)
+    {
+        auto const until = start("write");
+        while (size)
+        {
+            if (!ready(until, false, "write"))
+                continue;
+            auto const rval = ::send(socket_, data, chunk(size), flags(until));
+            if (rval >= 0)
+            {
+                data += rval;
+                size -= static_cast<std::size_t>(rval);
+                continue;
+            }
+            check(until, false, "write");
+        }
+    }
+
+    deadline::clock::time_point start(char const *what) const
+    {
+        if (deadline_.expired())
+            throw boost::system::system_error(boost::asio::error::timed_out, what);
+        return deadline_.next();
+    }
+
+    static int flags(deadline::clock::time_point until) noexcept
+    {
+        int res = 0;
+#ifdef MSG_NOSIGNAL
+        res |= MSG_NOSIGNAL;
+#endif  // !MSG_NOSIGNAL
+#ifdef MSG_DONTWAIT
+        if (until != deadline::none)
+            res |= MSG_DONTWAIT;
+#else
+        (void)until;
+#endif  // !MSG_DONTWAIT
+        return res;
+    }
+
+#ifdef BOOST_ASIO_WINDOWS
+    static int chunk(std::size_t size) noexcept
+    {
+        return static_cast<int>(std::min<std::size_t>(size, INT_MAX));
+    }
+
+    static int last_error() noexcept
+    {
+        return ::WSAGetLastError();
+    }
+#else
+    static std::size_t chunk(std::size_t size) noexcept
+    {
+        return size;
+    }
+
+    static int last_error() noexcept
+    {
+        return errno;
+    }
+#endif  // !BOOST_ASIO_WINDOWS
+
+    // Without MSG_DONTWAIT the socket is polled before each operation
+    // with a deadline. Returns false if it has to be polled again.
+    bool ready(deadline::clock::time_point until, bool read, char const *what)
     {
+#ifdef MSG_DONTWAIT
+        (void)until;
+        (void)read;
+        (void)what;
+        return true;
+#else
+        if (until == deadline::none)
+            return true;
         boost::system::error_code ec;
-        auto rval = socket_.write_some(boost::asio::buffer(
-                s, static_cast<std::size_t>(n)), ec);
-        if (!ec)
-            return static_cast<std::streamsize>(rval);
-        else if (ec == boost::asio::error::eof)
-            return static_cast<std::streamsize>(-1);
-        else
-            throw boost::system::system_error(ec, "write_some");
+        if (wait(until, read, ec))
+            return true;
+        if (ec)
+            fail(ec, what);
+        return false;
+#endif  // !MSG_DONTWAIT
+    }
+
+    // Throws if the failed operation can't be retried.
+    void check(deadline::clock::time_point until, bool read, char const *what)
+    {
+        boost::system::error_code ec{last_error(), boost::system::system_category()};
+        if (ec == boost::asio::error::interrupted)
+            return;
+        if ((ec == boost::asio::error::would_block || ec == boost::asio::error::try_again) &&
+                until != deadline::none && wait(until, read, ec))
+        {
+            return;
+        }
+        fail(ec, what);
     }
 
+    // Waits until the socket is ready or the deadline is missed.
+    // Returns false without an error if the wait is interrupted.
+    bool wait(deadline::clock::time_point until, bool read, boost::system::error_code &ec)
+    {
+        auto const msec = deadline::milliseconds_left(until);
+        if (!msec)
+        {
+            ec = boost::asio::error::timed_out;
+            return false;
+        }
 
+#ifdef BOOST_ASIO_WINDOWS
+        WSAPOLLFD fd{socket_, static_cast<SHORT>(read ? POLLIN : POLLOUT), 0};
+        auto const rc = ::WSAPoll(&fd, 1, msec);
+#else
+        pollfd fd{socket_, static_cast<short>(read ? POLLIN : POLLOUT), 0};
+        auto const rc = ::poll(&fd, 1, msec);
+#endif  // !BOOST_ASIO_WINDOWS
+        if (rc < 0)
+        {
+            ec = boost::system::error_code{last_error(), boost::system::system_category()};
+            // The operation is retried and waits again.
+            if (ec == boost::asio::error::interrupted)
+                ec.clear();
+            return false;
+        }
+        if (rc == 0)
+        {
+            ec = boost::asio::error::timed_out;
+            return false;
+        }
+        return true;
+    }
 
-private:
-    boost::asio::ip::tcp::socket& socket_;
+    // The data of the operation which missed its deadline may come later,
+    // so the stream can't be used anymore.
+    [[noreturn]]
+    void fail(boost::system::error_code const &ec, char const *what)
+    {
+        if (ec == boost::asio::error::timed_out)
+            deadline_.expire();
+        {
+            std::lock_guard<std::mutex> lock{mutex_};
+            error_ = ec;
+        }
+        throw boost::system::system_error(ec, what);
+    }
+};
+
+class socket_stream final
+    : public std::iostream
+{
+public:
+    socket_stream(socket_streambuf::native_handle_type socket,
+            std::size_t read_buffer_size = 0, std::size_t write_buffer_size = 0)
+        : std::iostream{nullptr}
+        , buffer_{socket, deadline_, read_buffer_size, write_buffer_size}
+    {
+        rdbuf(&buffer_);
+    }
+
+    [[nodiscard]]
+    std::error_code error() const
+    {
+        return buffer_.error();
+    }
+
+    [[nodiscard]]
+    detail::deadline& deadline() noexcept
+    {
+        return deadline_;
+    }
+
+    [[nodiscard]]
+    socket_streambuf::native_handle_type native_handle() const noexcept
+    {
+        return buffer_.native_handle();
+    }
 
+private:
+    detail::deadline deadline_;
+    socket_streambuf buffer_;
 };
 
 class stream final
 {
 public:
-    stream(std::string_view host, std::string_view port)
+    stream(std::string_view host, std::string_view port,
+            stream_options const &options)
     {
-#ifndef REDISCPP_EASY_ADDRESS_RESOLVE
-        auto get_endpoint = [this, host, port]
-            {
-                boost::asio::ip::tcp::resolver resolver{io_context_};
-                auto endpoints = resolver.resolve(std::move(host), std::move(port));
-                auto iter = std::begin(endpoints);
-                if (iter == std::end(endpoints))
-                    throw std::runtime_error{"There is no any endpoint."};
-                return iter->endpoint();
-            };
-#else
-        auto get_endpoint = [host, port] () -> boost::asio::ip::tcp::endpoint
-            {
-                return {boost::asio::ip::address::from_string(host.data()),
-                    static_cast<std::uint16_t>(std::atoi(port.data()))};
-            };
-#endif  // !REDISCPP_EASY_ADDRESS_RESOLVE
-        socket_.connect(get_endpoint());
-        socket_.set_option(boost::asio::ip::tcp::no_delay{});
+        boost::system::error_code ec;
+        connect(std::move(host), std::move(port), options, ec);
+        if (ec)
+            throw boost::system::system_error{ec, "connect"};
+        if (auto err = handshake(options))
+            err.raise();
+    }
 
-        stream_ = std::make_unique<stream_type>(socket_);
+    stream(std::string_view host, std::string_view port,
+            stream_options const &options, std::error_code &ec)
+    {
+        boost::system::error_code error;
+        connect(std::move(host), std::move(port), options, error);
+        ec = error;
+        if (!ec)
+            ec = handshake(options).code();
     }
 
     [[nodiscard]]
@@ -107,10 +450,269 @@ public:
 
 private:
     boost::asio::io_context io_context_;
-    boost::asio::ip::tcp::socket socket_{io_context_};
+    boost::asio::generic::stream_protocol::socket socket_{io_context_};
+    std::unique_ptr<std::iostream> stream_;
+
+    static constexpr std::string_view unix_scheme = "unix://";
+
+    void connect(std::string_view host, std::string_view port,
+            stream_options const &options, boost::system::error_code &ec)
+    {
+        if (host.substr(0, std::size(unix_scheme)) == unix_scheme)
+            connect_local(host.substr(std::size(unix_scheme)), options, ec);
+        else
+            connect_tcp(std::move(host), std::move(port), options, ec);
+        if (ec)
+            return;
 
-    using stream_type = boost::iostreams::stream<tcp_stream_device>;
-    std::unique_ptr<stream_type> stream_;
+        set_affinity(options, ec);
+        if (ec)
+            return;
+
+#if defined(REDISCPP_IO_URING) && defined(__linux__)
+        // Falls back to the socket stream if io_uring isn't available.
+        if (auto ring = uring::for_this_thread())
+        {
+            auto ring_stream = std::make_unique<uring_stream>(std::move(ring),
+                    socket_.native_handle(), options.read_buffer_size, options.write_buffer_size);
+            ring_stream->deadline().set_timeout(options.timeout);
+            stream_ = std::move(ring_stream);
+            return;
+        }
+#endif  // !REDISCPP_IO_URING && __linux__
+
+        auto socket_stream = std::make_unique<detail::socket_stream>(socket_.native_handle(),
+                options.read_buffer_size, options.write_buffer_size);
+        socket_stream->deadline().set_timeout(options.timeout);
+        stream_ = std::move(socket_stream);
+    }
+
+    void connect_tcp(std::string_view host, std::string_view port,
+            stream_options const &options, boost::system::error_code &ec)
+    {
+#ifndef REDISCPP_EASY_ADDRESS_RESOLVE
+        boost::asio::ip::tcp::resolver resolver{io_context_};
+        auto endpoints = resolver.resolve(std::move(host), std::move(port), ec);
+        if (ec)
+            return;
+        auto iter = std::begin(endpoints);
+        if (iter == std::end(endpoints))
+        {
+            ec = boost::asio::error::host_not_found;
+            return;
+        }
+        boost::asio::ip::tcp::endpoint endpoint = iter->endpoint();
+#else
+        boost::asio::ip::tcp::endpoint endpoint{
+                boost::asio::ip::address::from_string(host.data(), ec),
+                static_cast<std::uint16_t>(std::atoi(port.data()))
+            };
+        if (ec)
+            return;
+#endif  // !REDISCPP_EASY_ADDRESS_RESOLVE
+        open(boost::asio::generic::stream_protocol::endpoint{endpoint}, options, ec);
+        if (ec)
+            return;
+
+#ifdef __linux__
+        if (options.busy_poll > 0 && !set_option(SOL_SOCKET, SO_BUSY_POLL, options.busy_poll, ec))
+            return;
+#endif  // !__linux__
+
+        connect_socket(endpoint, options, ec);
+        if (ec)
+            return;
+
+        if (options.no_delay)
+        {
+            socket_.set_option(boost::asio::ip::tcp::no_delay{true}, ec);
+            if (ec)
+                return;
+        }
+
+        if (options.keep_alive)
+        {
+            socket_.set_option(boost::asio::socket_base::keep_alive{true}, ec);
+            if (ec)
+                return;
+#ifdef __linux__
+            if (options.keep_alive_idle > 0 &&
+                    !set_option(IPPROTO_TCP, TCP_KEEPIDLE, options.keep_alive_idle, ec))
+            {
+                return;
+            }
+            if (options.keep_alive_interval > 0 &&
+                    !set_option(IPPROTO_TCP, TCP_KEEPINTVL, options.keep_alive_interval, ec))
+            {
+                return;
+            }
+            if (options.keep_alive_count > 0 &&
+                    !set_option(IPPROTO_TCP, TCP_KEEPCNT, options.keep_alive_count, ec))
+            {
+                return;
+            }
+#endif  // !__linux__
+        }
+
+#ifdef __linux__
+        // The kernel may reset TCP_QUICKACK, it's only a hint for the first replies.
+        if (options.quick_ack && !set_option(IPPROTO_TCP, TCP_QUICKACK, 1, ec))
+            return;
+#endif  // !__linux__
+    }
+
+    // TCP options aren't applicable to a Unix domain socket.
+    void connect_local(std::string_view path, stream_options const &options,
+            boost::system::error_code &ec)
+    {
+#ifdef BOOST_ASIO_HAS_LOCAL_SOCKETS
+        boost::asio::local::stream_protocol::endpoint endpoint{std::string{path}};
+        open(boost::asio::generic::stream_protocol::endpoint{endpoint}, options, ec);
+        if (ec)
+            return;
+        connect_socket(endpoint, options, ec);
+#else
+        (void)path;
+        (void)options;
+        ec = boost::asio::error::operation_not_supported;
+#endif  // !BOOST_ASIO_HAS_LOCAL_SOCKETS
+    }
+
+    // The connection is canceled if it isn't established within the timeout.
+    template <typename TEndpoint>
+    void connect_socket(TEndpoint const &endpoint, stream_options const &options,
+            boost::system::error_code &ec)
+    {
+        if (options.timeout.count() <= 0)
+        {
+            socket_.connect(endpoint, ec);
+            return;
+        }
+
+        ec = boost::asio::error::would_block;
+        socket_.async_connect(endpoint, [&ec] (boost::system::error_code const &error)
+                { ec = error; });
+        io_context_.run_for(options.timeout);
+        if (ec != boost::asio::error::would_block)
+            return;
+
+        socket_.cancel();
+        io_context_.restart();
+        io_context_.run();
+        ec = boost::asio::error::timed_out;
+    }
+
+    // Socket buffers have to be set before connecting to take effect on the TCP window.
+    void open(boost::asio::generic::stream_protocol::endpoint const &endpoint,
+            stream_options const &options, boost::system::error_code &ec)
+    {
+        socket_.open(endpoint.protocol(), ec);
+        if (ec)
+            return;
+
+        if (options.receive_buffer_size > 0)
+        {
+            socket_.set_option(boost::asio::socket_base::receive_buffer_size{
+                    options.receive_buffer_size}, ec);
+            if (ec)
+                return;
+        }
+
+        if (options.send_buffer_size > 0)
+        {
+            socket_.set_option(boost::asio::socket_base::send_buffer_size{
+                    options.send_buffer_size}, ec);
+        }
+    }
+
+#ifdef __linux__
+    bool set_option(int level, int name, int value, boost::system::error_code &ec)
+    {
+        if (::setsockopt(socket_.native_handle(), level, name, &value, sizeof(value)) == 0)
+            return true;
+        ec = boost::system::error_code{errno, boost::system::system_category()};
+        return false;
+    }
+#endif  // !__linux__
+
+    static void set_affinity(stream_options const &options, boost::system::error_code &ec)
+    {
+#ifdef __linux__
+        if (options.cpu < 0)
+            return;
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        CPU_SET(static_cast<std::size_t>(options.cpu), &set);
+        if (auto const rc = ::pthread_setaffinity_np(::pthread_self(), sizeof(set), &set))
+            ec = boost::system::error_code{rc, boost::system::system_category()};
+#else
+        (void)options;
+        (void)ec;
+#endif  // !__linux__
+    }
+
+    // All the handshake commands are sent at once and their replies
+    // are read after that, so it takes a single round trip.
+    // The transport doesn't depend on the RESP headers, the commands
+    // and their simple replies are handled here.
+    [[nodiscard]]
+    error handshake(stream_options const &options)
+    {
+        auto &stream = *stream_;
+        std::size_t count = 0;
+
+        if (!options.password.empty())
+        {
+            if (options.user.empty())
+                write_command(stream, {"auth", options.password});
+            else
+                write_command(stream, {"auth", options.user, options.password});
+            ++count;
+        }
+
+        if (options.database > 0)
+        {
+            write_command(stream, {"select", std::to_string(options.database)});
+            ++count;
+        }
+
+        if (!options.client_name.empty())
+        {
+            write_command(stream, {"client", "setname", options.client_name});
+            ++count;
+        }
+
+        if (!count)
+            return {};
+
+        std::flush(stream);
+
+        error result;
+        std::string line;
+        while (count--)
+        {
+            if (!std::getline(stream, line))
+                return make_error_code(errc::io_error);
+            if (!line.empty() && line.back() == '\r')
+                line.pop_back();
+            if (line.empty() || (line.front() != '+' && line.front() != '-'))
+                return make_error_code(errc::bad_format);
+            if (line.front() == '-' && !result)
+            {
+                line.erase(0, 1);
+                result = error{make_error_code(server_error_code(line)), line};
+            }
+        }
+        return result;
+    }
+
+    static void write_command(std::ostream &stream,
+            std::initializer_list<std::string_view> args)
+    {
+        stream << '*' << std::size(args) << "\r\n";
+        for (auto const &arg : args)
+            stream << '$' << std::size(arg) << "\r\n" << arg << "\r\n";
+    }
 };
 
 }   // namespace detail
@@ -121,10 +723,230 @@ inline
 std::shared_ptr<std::iostream> make_stream(std::string_view host,
                                            std::string_view port)
 {
-    auto stream = std::make_shared<detail::stream>(std::move(host), std::move(port));
+    return make_stream(std::move(host), std::move(port), stream_options{});
+}
+
+#ifdef REDISCPP_HEADER_ONLY
+inline
+#endif  // !REDISCPP_HEADER_ONLY
+std::shared_ptr<std::iostream> make_stream(std::string_view host,
+                                           std::string_view port,
+                                           std::error_code &ec) noexcept
+{
+    return make_stream(std::move(host), std::move(port), stream_options{}, ec);
+}
+
+#ifdef REDISCPP_HEADER_ONLY
+inline
+#endif  // !REDISCPP_HEADER_ONLY
+std::shared_ptr<std::iostream> make_stream(std::string_view host,
+                                           std::string_view port,
+                                           stream_options const &options)
+{
+    auto stream = std::make_shared<detail::stream>(std::move(host), std::move(port), options);
     return std::shared_ptr<std::iostream>{stream, stream->get_stream()};
 }
 
+#ifdef REDISCPP_HEADER_ONLY
+inline
+#endif  // !REDISCPP_HEADER_ONLY
+std::shared_ptr<std::iostream> make_stream(std::string_view host,
+                                           std::string_view port,
+                                           stream_options const &options,
+                                           std::error_code &ec) noexcept
+{
+    try
+    {
+        auto stream = std::make_shared<detail::stream>(std::move(host), std::move(port), options, ec);
+        if (ec)
+            return {};
+        return std::shared_ptr<std::iostream>{stream, stream->get_stream()};
+    }
+    catch (std::bad_alloc const &)
+    {
+        ec = std::make_error_code(std::errc::not_enough_memory);
+    }
+    catch (boost::system::system_error const &e)
+    {
+        ec = e.code();
+    }
+    return {};
+}
+
+#ifdef REDISCPP_HEADER_ONLY
+inline
+#endif  // !REDISCPP_HEADER_ONLY
+std::error_code get_error(std::iostream const &stream) noexcept
+{
+    auto const *target = &stream;
+    while (auto *wrapper = dynamic_cast<wrapped_stream const *>(target))
+        target = &wrapper->wrapped();
+
+#if defined(REDISCPP_IO_URING) && defined(__linux__)
+    if (auto *ring_stream = dynamic_cast<detail::uring_stream const *>(target))
+        return ring_stream->error();
+#endif  // !REDISCPP_IO_URING && __linux__
+
+    auto *socket_stream = dynamic_cast<detail::socket_stream const *>(target);
+    if (!socket_stream)
+        return {};
+    return socket_stream->error();
+}
+
+namespace detail
+{
+
+// Returns the stream made by make_stream under the wrappers.
+inline std::iostream& unwrap(std::iostream &stream) noexcept
+{
+    auto *res = &stream;
+    while (auto *wrapper = dynamic_cast<wrapped_stream *>(res))
+        res = &wrapper->wrapped();
+    return *res;
+}
+
+inline deadline* get_deadline(std::iostream &stream) noexcept
+{
+    auto &target = unwrap(stream);
+
+#if defined(REDISCPP_IO_URING) && defined(__linux__)
+    if (auto *ring_stream = dynamic_cast<uring_stream *>(&target))
+        return &ring_stream->deadline();
+#endif  // !REDISCPP_IO_URING && __linux__
+
+    auto *socket_stream = dynamic_cast<detail::socket_stream *>(&target);
+    if (!socket_stream)
+        return nullptr;
+    return &socket_stream->deadline();
+}
+
+}   // namespace detail
+
+#ifdef REDISCPP_HEADER_ONLY
+inline
+#endif  // !REDISCPP_HEADER_ONLY
+void set_deadline(std::iostream &stream,
+                  std::chrono::steady_clock::time_point deadline) noexcept
+{
+    if (auto *state = detail::get_deadline(stream))
+        state->set(deadline);
+}
+
+#ifdef REDISCPP_HEADER_ONLY
+inline
+#endif  // !REDISCPP_HEADER_ONLY
+void set_timeout(std::iostream &stream,
+                 std::chrono::steady_clock::duration timeout) noexcept
+{
+    if (auto *state = detail::get_deadline(stream))
+        state->set_timeout(timeout);
+}
+
+#ifdef REDISCPP_HEADER_ONLY
+inline
+#endif  // !REDISCPP_HEADER_ONLY
+void shutdown_read(std::iostream &stream) noexcept
+{
+    auto &target = detail::unwrap(stream);
+    auto *state = detail::get_deadline(target);
+    if (!state)
+        return;
+    state->expire();
+
+#ifdef BOOST_ASIO_WINDOWS
+    constexpr auto how = SD_RECEIVE;
+#else
+    constexpr auto how = SHUT_RD;
+#endif  // !BOOST_ASIO_WINDOWS
+
+#if defined(REDISCPP_IO_URING) && defined(__linux__)
+    if (auto *ring_stream = dynamic_cast<detail::uring_stream *>(&target))
+    {
+        ::shutdown(ring_stream->native_handle(), how);
+        return;
+    }
+#endif  // !REDISCPP_IO_URING && __linux__
+
+    if (auto *socket_stream = dynamic_cast<detail::socket_stream *>(&target))
+        ::shutdown(socket_stream->native_handle(), how);
+}
+
+#ifdef REDISCPP_HEADER_ONLY
+inline
+#endif  // !REDISCPP_HEADER_ONLY
+int wait_readable(std::vector<std::iostream *> const &streams,
+                  std::chrono::steady_clock::time_point deadline)
+{
+#if defined(REDISCPP_IO_URING) && defined(__linux__)
+    // The completions of the receives are waited for on the ring.
+    auto *first = std::empty(streams) ? nullptr :
+            dynamic_cast<detail::uring_stream *>(&detail::unwrap(*streams.front()));
+    if (first)
+    {
+        for (;;)
+        {
+            for (std::size_t i = 0 ; i < std::size(streams) ; ++i)
+            {
+                // A wrapper may have received data in its own buffer.
+                if (streams[i]->rdbuf()->in_avail() > 0)
+                    return static_cast<int>(i);
+                auto *ring_stream = dynamic_cast<detail::uring_stream *>(&detail::unwrap(*streams[i]));
+                if (ring_stream && ring_stream->readable())
+                    return static_cast<int>(i);
+            }
+            if (auto ec = first->ring().run_once(deadline))
+            {
+                if (ec == std::errc::timed_out)
+                    return -1;
+                // The stream is broken, reading it fails.
+                return 0;
+            }
+        }
+    }
+#endif  // !REDISCPP_IO_URING && __linux__
+
+#ifdef BOOST_ASIO_WINDOWS
+    std::vector<WSAPOLLFD> fds;
+#else
+    std::vector<pollfd> fds;
+#endif  // !BOOST_ASIO_WINDOWS
+    fds.reserve(std::size(streams));
+    for (std::size_t i = 0 ; i < std::size(streams) ; ++i)
+    {
+        // The data buffered by a wrapper or by the stream itself is readable.
+        auto *stream = streams[i];
+        if (stream->rdbuf()->in_avail() > 0)
+            return static_cast<int>(i);
+        auto *socket_stream = dynamic_cast<detail::socket_stream *>(&detail::unwrap(*stream));
+        if (!socket_stream || socket_stream->deadline().expired())
+            return static_cast<int>(i);
+        fds.push_back({socket_stream->native_handle(), POLLIN, 0});
+    }
+
+    for (;;)
+    {
+        auto const msec = detail::deadline::milliseconds_left(deadline);
+#ifdef BOOST_ASIO_WINDOWS
+        auto const rc = ::WSAPoll(std::data(fds), static_cast<ULONG>(std::size(fds)), msec);
+#else
+        auto const rc = ::poll(std::data(fds), static_cast<nfds_t>(std::size(fds)), msec);
+#endif  // !BOOST_ASIO_WINDOWS
+        if (rc == 0)
+            return -1;
+        if (rc < 0)
+        {
+            if (errno == EINTR)
+                continue;
+            return 0;
+        }
+        for (std::size_t i = 0 ; i < std::size(fds) ; ++i)
+        {
+            if (fds[i].revents)
+                return static_cast<int>(i);
+        }
+    }
+}
+
 }   // namespace rediscpp
 
 #endif  // !REDISCPP_PURE_CORE
@@ -0,0 +1,891 @@
+//-------------------------------------------------------------------
+//  redis-cpp
+//  https://github.com/tdv/redis-cpp
+//  Created:     10.2026
+//  Copyright 2020 Dmitry Tkachenko (tkachenkodmitryv@gmail.com)
+//  Distributed under the MIT License
+//  (See accompanying file LICENSE)
+//-------------------------------------------------------------------
+
+#ifndef REDISCPP_DETAIL_URING_HPP_
+#define REDISCPP_DETAIL_URING_HPP_
+
+#if defined(REDISCPP_IO_URING) && defined(__linux__)
+
+// STD
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <climits>
+#include <condition_variable>
+#include <cstdint>
+#include <cstring>
+#include <istream>
+#include <memory>
+#include <mutex>
+#include <streambuf>
+#include <system_error>
+#include <vector>
+
+// LINUX
+#include <linux/io_uring.h>
+#include <signal.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/syscall.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+// REDIS-CPP
+#include <redis-cpp/detail/deadline.hpp>
+
+namespace rediscpp
+{
+namespace detail
+{
+
+// A minimal io_uring wrapper over the raw system calls. The ring is shared
+// by all streams of a thread: the submissions of the streams are batched
+// and are sent to the kernel with the next wait on the ring, e.g. a read
+// of any stream of the thread. A flush enters the kernel only if another
+// thread is waiting on the ring or submit_batch operations are queued,
+// and a stream which is destroyed completes its sends first.
+// Read buffers of the streams are registered in the ring (fixed buffers).
+// Waits with a timeout need IORING_FEAT_EXT_ARG (Linux 5.11 or higher).
+class uring final
+{
+public:
+    struct operation final
+    {
+        std::atomic<bool> done{true};
+        std::int32_t result = 0;
+    };
+
+    class buffer final
+    {
+    public:
+        buffer(uring &ring, char *data, int index, std::size_t size)
+            : ring_{&ring}
+            , data_{data}
+            , index_{index}
+            , size_{size}
+        {
+        }
+
+        buffer(std::size_t size)
+            : heap_(size)
+            , data_{std::data(heap_)}
+            , size_{size}
+        {
+        }
+
+        buffer(buffer const &) = delete;
+        buffer& operator = (buffer const &) = delete;
+
+        ~buffer() noexcept
+        {
+            if (ring_)
+                ring_->release(index_);
+        }
+
+        [[nodiscard]]
+        char* data() noexcept
+        {
+            return data_;
+        }
+
+        [[nodiscard]]
+        std::size_t size() const noexcept
+        {
+            return size_;
+        }
+
+        // The index of a registered buffer or -1.
+        [[nodiscard]]
+        int index() const noexcept
+        {
+            return index_;
+        }
+
+    private:
+        uring *ring_ = nullptr;
+        std::vector<char> heap_;
+        char *data_;
+        int index_ = -1;
+        std::size_t size_;
+    };
+
+    static constexpr unsigned default_entries = 256;
+    static constexpr std::size_t default_buffers = 32;
+    static constexpr std::size_t default_buffer_size = 16 * 1024;
+    static constexpr unsigned submit_batch = 32;
+
+    uring(unsigned entries = default_entries,
+            std::size_t buffers = default_buffers,
+            std::size_t buffer_size = default_buffer_size)
+        : buffer_size_{buffer_size}
+    {
+        io_uring_params params{};
+        fd_ = static_cast<int>(::syscall(__NR_io_uring_setup, entries, &params));
+        if (fd_ < 0)
+            throw std::system_error{errno, std::system_category(), "io_uring_setup"};
+
+        if (!(params.features & IORING_FEAT_EXT_ARG))
+        {
+            ::close(fd_);
+            throw std::system_error{ENOSYS, std::system_category(), "io_uring_setup"};
+        }
+
+        try
+        {
+            map(params);
+        }
+        catch (...)
+        {
+            unmap();
+            ::close(fd_);
+            throw;
+        }
+
+        register_buffers(buffers);
+    }
+
+    uring(uring const &) = delete;
+    uring& operator = (uring const &) = delete;
+
+    ~uring() noexcept
+    {
+        unmap();
+        ::close(fd_);
+    }
+
+    // Returns the ring of the current thread or nullptr if io_uring
+    // is not available (old kernel, seccomp and so on).
+    [[nodiscard]]
+    static std::shared_ptr<uring> for_this_thread()
+    {
+        static thread_local std::weak_ptr<uring> instance;
+        static thread_local bool unavailable = false;
+
+        if (unavailable)
+            return {};
+
+        auto ring = instance.lock();
+        if (ring)
+            return ring;
+
+        try
+        {
+            ring = std::make_shared<uring>();
+            instance = ring;
+        }
+        catch (std::system_error const &)
+        {
+            unavailable = true;
+        }
+        return ring;
+    }
+
+    // A registered buffer is taken if there is a free one which is large enough.
+    [[nodiscard]]
+    std::unique_ptr<buffer> acquire(std::size_t size = 0)
+    {
+        if (!size)
+            size = buffer_size_;
+
+        if (size <= buffer_size_)
+        {
+            std::lock_guard<std::mutex> lock{mutex_};
+            if (!free_buffers_.empty())
+            {
+                auto const index = free_buffers_.back();
+                free_buffers_.pop_back();
+                return std::make_unique<buffer>(*this,
+                        std::data(buffers_) + static_cast<std::size_t>(index) * buffer_size_,
+                        index, buffer_size_);
+            }
+        }
+        return std::make_unique<buffer>(size);
+    }
+
+    void send(int fd, char const *data, std::size_t size, operation &op, bool link)
+    {
+        std::lock_guard<std::mutex> lock{mutex_};
+        auto &sqe = prepare(IORING_OP_SEND, fd, data, size, op);
+        sqe.msg_flags = MSG_NOSIGNAL | MSG_WAITALL;
+        if (link)
+            sqe.flags |= IOSQE_IO_LINK;
+    }
+
+    void receive(int fd, buffer &buf, operation &op)
+    {
+        std::lock_guard<std::mutex> lock{mutex_};
+        if (buf.index() < 0)
+        {
+            prepare(IORING_OP_RECV, fd, buf.data(), buf.size(), op);
+        }
+        else
+        {
+            auto &sqe = prepare(IORING_OP_READ_FIXED, fd, buf.data(), buf.size(), op);
+            sqe.off = static_cast<__u64>(-1);
+            sqe.buf_index = static_cast<__u16>(buf.index());
+        }
+    }
+
+    void cancel(operation &target, operation &op)
+    {
+        std::lock_guard<std::mutex> lock{mutex_};
+        auto &sqe = prepare(IORING_OP_ASYNC_CANCEL, -1, nullptr, 0, op);
+        sqe.addr = reinterpret_cast<__u64>(&target);
+    }
+
+    // Queued operations are submitted by the next wait. They are submitted
+    // now if another thread is already waiting in the kernel or there are
+    // enough of them for a batch.
+    [[nodiscard]]
+    std::error_code submit()
+    {
+        std::unique_lock<std::mutex> lock{mutex_};
+        auto const to_submit = pending();
+        if (!to_submit || (!polling_ && to_submit < submit_batch))
+            return {};
+        return enter(to_submit, 0, lock);
+    }
+
+    // Submits the queued operations and waits until at least one of them
+    // is completed. Only one thread waits in the kernel, others wait for it.
+    // Returns std::errc::timed_out if nothing is completed by the deadline.
+    [[nodiscard]]
+    std::error_code run_once(deadline::clock::time_point until = deadline::none)
+    {
+        std::unique_lock<std::mutex> lock{mutex_};
+        auto const generation = generation_;
+        auto const to_submit = pending();
+
+        // Completions are reaped only by the waiting thread, otherwise
+        // it could wait in the kernel for a completion that has been taken.
+        if (polling_)
+        {
+            if (to_submit)
+            {
+                if (auto ec = enter(to_submit, 0, lock))
+                    return ec;
+            }
+            auto const ready = [this, generation]
+                    { return generation_ != generation || !polling_; };
+            if (until == deadline::none)
+                ready_.wait(lock, ready);
+            else if (!ready_.wait_until(lock, until, ready))
+                return std::make_error_code(std::errc::timed_out);
+            return {};
+        }
+
+        if (reap() > 0)
+        {
+            ++generation_;
+            ready_.notify_all();
+            return to_submit ? enter(to_submit, 0, lock) : std::error_code{};
+        }
+
+        polling_ = true;
+        lock.unlock();
+        auto ec = enter(to_submit, 1, lock, until);
+        if (!lock.owns_lock())
+            lock.lock();
+        polling_ = false;
+        reap();
+        ++generation_;
+        ready_.notify_all();
+        return ec;
+    }
+
+private:
+    int fd_ = -1;
+
+    void *sq_ring_ = MAP_FAILED;
+    std::size_t sq_ring_size_ = 0;
+    void *cq_ring_ = MAP_FAILED;
+    std::size_t cq_ring_size_ = 0;
+    io_uring_sqe *sqes_ = static_cast<io_uring_sqe *>(MAP_FAILED);
+    std::size_t sqes_size_ = 0;
+
+    unsigned *sq_head_ = nullptr;
+    unsigned *sq_tail_ = nullptr;
+    unsigned sq_mask_ = 0;
+    unsigned sq_entries_ = 0;
+    unsigned *sq_array_ = nullptr;
+
+    unsigned *cq_head_ = nullptr;
+    unsigned *cq_tail_ = nullptr;
+    unsigned cq_mask_ = 0;
+    io_uring_cqe *cqes_ = nullptr;
+
+    std::mutex mutex_;
+    std::condition_variable ready_;
+    bool polling_ = false;
+    std::uint64_t generation_ = 0;
+
+    std::size_t buffer_size_;
+    std::vector<char> buffers_;
+    std::vector<int> free_buffers_;
+
+    template <typename T>
+    static T* at(void *base, std::uint32_t offset) noexcept
+    {
+        return reinterpret_cast<T *>(static_cast<char *>(base) + offset);
+    }
+
+    void map(io_uring_params const &params)
+    {
+        sq_ring_size_ = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+        cq_ring_size_ = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+
+        bool const single_mmap = params.features & IORING_FEAT_SINGLE_MMAP;
+        if (single_mmap)
+            sq_ring_size_ = cq_ring_size_ = std::max(sq_ring_size_, cq_ring_size_);
+
+        sq_ring_ = ::mmap(nullptr, sq_ring_size_, PROT_READ | PROT_WRITE,
+                MAP_SHARED | MAP_POPULATE, fd_, IORING_OFF_SQ_RING);
+        if (sq_ring_ == MAP_FAILED)
+            throw std::system_error{errno, std::system_category(), "mmap"};
+
+        if (single_mmap)
+        {
+            cq_ring_ = sq_ring_;
+        }
+        else
+        {
+            cq_ring_ = ::mmap(nullptr, cq_ring_size_, PROT_READ | PROT_WRITE,
+                    MAP_SHARED | MAP_POPULATE, fd_, IORING_OFF_CQ_RING);
+            if (cq_ring_ == MAP_FAILED)
+                throw std::system_error{errno, std::system_category(), "mmap"};
+        }
+
+        sqes_size_ = params.sq_entries * sizeof(io_uring_sqe);
+        sqes_ = static_cast<io_uring_sqe *>(::mmap(nullptr, sqes_size_,
+                PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd_, IORING_OFF_SQES));
+        if (sqes_ == MAP_FAILED)
+            throw std::system_error{errno, std::system_category(), "mmap"};
+
+        sq_head_ = at<unsigned>(sq_ring_, params.sq_off.head);
+        sq_tail_ = at<unsigned>(sq_ring_, params.sq_off.tail);
+        sq_mask_ = *at<unsigned>(sq_ring_, params.sq_off.ring_mask);
+        sq_entries_ = *at<unsigned>(sq_ring_, params.sq_off.ring_entries);
+        sq_array_ = at<unsigned>(sq_ring_, params.sq_off.array);
+
+        cq_head_ = at<unsigned>(cq_ring_, params.cq_off.head);
+        cq_tail_ = at<unsigned>(cq_ring_, params.cq_off.tail);
+        cq_mask_ = *at<unsigned>(cq_ring_, params.cq_off.ring_mask);
+        cqes_ = at<io_uring_cqe>(cq_ring_, params.cq_off.cqes);
+    }
+
+    void unmap() noexcept
+    {
+        if (sqes_ != MAP_FAILED)
+            ::munmap(sqes_, sqes_size_);
+        if (cq_ring_ != MAP_FAILED && cq_ring_ != sq_ring_)
+            ::munmap(cq_ring_, cq_ring_size_);
+        if (sq_ring_ != MAP_FAILED)
+            ::munmap(sq_ring_, sq_ring_size_);
+    }
+
+    // Registered buffers are optional. If the kernel refuses them
+    // (e.g. RLIMIT_MEMLOCK is too low), plain buffers are used.
+    void register_buffers(std::size_t count)
+    {
+        if (!count)
+            return;
+
+        buffers_.resize(count * buffer_size_);
+
+        std::vector<iovec> iovecs(count);
+        for (std::size_t i = 0 ; i < count ; ++i)
+            iovecs[i] = {std::data(buffers_) + i * buffer_size_, buffer_size_};
+
+        if (::syscall(__NR_io_uring_register, fd_, IORING_REGISTER_BUFFERS,
+                std::data(iovecs), static_cast<unsigned>(count)) < 0)
+        {
+            buffers_.clear();
+            buffers_.shrink_to_fit();
+            return;
+        }
+
+        free_buffers_.reserve(count);
+        for (auto i = static_cast<int>(count) ; i > 0 ; --i)
+            free_buffers_.push_back(i - 1);
+    }
+
+    void release(int index) noexcept
+    {
+        std::lock_guard<std::mutex> lock{mutex_};
+        free_buffers_.push_back(index);
+    }
+
+    [[nodiscard]]
+    unsigned pending() const noexcept
+    {
+        return *sq_tail_ - __atomic_load_n(sq_head_, __ATOMIC_ACQUIRE);
+    }
+
+    io_uring_sqe& prepare(__u8 opcode, int fd, void const *data,
+            std::size_t size, operation &op)
+    {
+        while (pending() >= sq_entries_)
+        {
+            std::unique_lock<std::mutex> lock{mutex_, std::adopt_lock};
+            auto ec = enter(pending(), 0, lock);
+            lock.release();
+            if (ec)
+                throw std::system_error{ec, "io_uring_enter"};
+        }
+
+        auto const tail = *sq_tail_;
+        auto const index = tail & sq_mask_;
+        auto &sqe = sqes_[index];
+        std::memset(&sqe, 0, sizeof(sqe));
+        sqe.opcode = opcode;
+        sqe.fd = fd;
+        sqe.addr = reinterpret_cast<__u64>(data);
+        sqe.len = static_cast<__u32>(size);
+        sqe.user_data = reinterpret_cast<__u64>(&op);
+        sq_array_[index] = index;
+
+        op.done.store(false, std::memory_order_relaxed);
+        __atomic_store_n(sq_tail_, tail + 1, __ATOMIC_RELEASE);
+
+        return sqe;
+    }
+
+    std::size_t reap() noexcept
+    {
+        std::size_t count = 0;
+        auto head = *cq_head_;
+        auto const tail = __atomic_load_n(cq_tail_, __ATOMIC_ACQUIRE);
+        for ( ; head != tail ; ++head, ++count)
+        {
+            auto const &cqe = cqes_[head & cq_mask_];
+            auto *op = reinterpret_cast<operation *>(cqe.user_data);
+            op->result = cqe.res;
+            op->done.store(true, std::memory_order_release);
+        }
+        __atomic_store_n(cq_head_, head, __ATOMIC_RELEASE);
+        return count;
+    }
+
+    // The lock isn't held while waiting for completions.
+    std::error_code enter(unsigned to_submit, unsigned min_complete,
+            std::unique_lock<std::mutex> &lock,
+            deadline::clock::time_point until = deadline::none)
+    {
+        for (;;)
+        {
+            unsigned flags = min_complete ? IORING_ENTER_GETEVENTS : 0;
+            __kernel_timespec ts{};
+            io_uring_getevents_arg arg{};
+            if (min_complete && until != deadline::none)
+            {
+                auto const left = std::max(until - deadline::clock::now(),
+                        deadline::clock::duration::zero());
+                auto const ns = std::chrono::duration_cast<std::chrono::nanoseconds>(left).count();
+                ts.tv_sec = ns / 1000000000;
+                ts.tv_nsec = ns % 1000000000;
+                arg.sigmask_sz = _NSIG / CHAR_BIT;
+                arg.ts = reinterpret_cast<__u64>(&ts);
+                flags |= IORING_ENTER_EXT_ARG;
+            }
+
+            auto const rc = ::syscall(__NR_io_uring_enter, fd_, to_submit, min_complete, flags,
+                    flags & IORING_ENTER_EXT_ARG ? static_cast<void *>(&arg) : nullptr,
+                    flags & IORING_ENTER_EXT_ARG ? sizeof(arg) : 0);
+            if (rc >= 0)
+                return {};
+            if (errno == ETIME)
+                return std::make_error_code(std::errc::timed_out);
+            if (errno == EINTR)
+                continue;
+            if (errno == EBUSY || errno == EAGAIN)
+            {
+                // The completion queue is full, it has to be reaped first.
+                if (!lock.owns_lock())
+                    lock.lock();
+                if (reap() == 0)
+                    return std::error_code{errno, std::system_category()};
+                ++generation_;
+                ready_.notify_all();
+                if (min_complete)
+                    return {};
+                to_submit = pending();
+                continue;
+            }
+            return std::error_code{errno, std::system_category()};
+        }
+    }
+};
+
+// The stream buffer puts data right into the ring buffers. A flush
+// queues a send and a linked receive of the reply into the read buffer,
+// so the reply is usually ready when it's read.
+// An operation which misses its deadline expires the stream, the pending
+// operations are canceled when the stream buffer is destroyed.
+class uring_streambuf final
+    : public std::streambuf
+{
+public:
+    uring_streambuf(std::shared_ptr<uring> ring, int fd, std::error_code &error,
+            detail::deadline &deadline, std::size_t read_buffer_size,
+            std::size_t write_buffer_size)
+        : ring_{std::move(ring)}
+        , fd_{fd}
+        , error_{error}
+        , deadline_{deadline}
+        , read_buffer_{ring_->acquire(read_buffer_size)}
+        , write_buffer_(write_buffer_size ? write_buffer_size : uring::default_buffer_size)
+    {
+        setg(read_buffer_->data(), read_buffer_->data(), read_buffer_->data());
+        setp(std::data(write_buffer_), std::data(write_buffer_) + std::size(write_buffer_));
+    }
+
+    ~uring_streambuf() noexcept override
+    {
+        try
+        {
+            auto const until = deadline_.next();
+            if (!deadline_.expired() && pptr() != pbase() && complete_write(until))
+                queue_send(false);
+            if (!deadline_.expired())
+                complete_write(until);
+
+            // The buffers belong to the kernel until the operations are completed.
+            if (read_pending_ && !read_op_.done.load(std::memory_order_acquire))
+                ring_->cancel(read_op_, cancel_read_op_);
+            if (write_pending_ && !write_op_.done.load(std::memory_order_acquire))
+                ring_->cancel(write_op_, cancel_write_op_);
+            while (!read_op_.done.load(std::memory_order_acquire) ||
+                    !write_op_.done.load(std::memory_order_acquire) ||
+                    !cancel_read_op_.done.load(std::memory_order_acquire) ||
+                    !cancel_write_op_.done.load(std::memory_order_acquire))
+            {
+                if (ring_->run_once())
+                    break;
+            }
+        }
+        catch (...)
+        {
+        }
+    }
+
+    // Returns true if a read won't wait: there is data in the get area
+    // or the receive is completed. A receive is queued if there is none,
+    // it's submitted by the next wait on the ring.
+    [[nodiscard]]
+    bool readable()
+    {
+        if (gptr() < egptr() || deadline_.expired())
+            return true;
+        std::lock_guard<std::mutex> lock{mutex_};
+        buffered_ = false;
+        if (!read_pending_)
+            queue_receive();
+        return read_op_.done.load(std::memory_order_acquire);
+    }
+
+    [[nodiscard]]
+    uring& ring() noexcept
+    {
+        return *ring_;
+    }
+
+    [[nodiscard]]
+    int native_handle() const noexcept
+    {
+        return fd_;
+    }
+
+protected:
+    int_type underflow() override
+    {
+        if (gptr() < egptr())
+            return traits_type::to_int_type(*gptr());
+
+        if (deadline_.expired())
+            return traits_type::eof();
+
+        auto const until = deadline_.next();
+        std::unique_lock<std::mutex> lock{mutex_};
+        buffered_ = false;
+
+        if (!read_pending_)
+            queue_receive();
+
+        for (;;)
+        {
+            if (!check_write())
+                return traits_type::eof();
+
+            if (read_op_.done.load(std::memory_order_acquire))
+            {
+                auto const result = read_op_.result;
+                if (result > 0)
+                {
+                    read_pending_ = false;
+                    buffered_ = true;
+                    setg(read_buffer_->data(), read_buffer_->data(),
+                            read_buffer_->data() + result);
+                    return traits_type::to_int_type(*gptr());
+                }
+                // The receive is canceled when the linked send is short.
+                if (result == -ECANCELED || result == -EINTR || result == -EAGAIN)
+                {
+                    queue_receive();
+                    continue;
+                }
+                read_pending_ = false;
+                if (result < 0)
+                    error_ = std::error_code{-result, std::system_category()};
+                return traits_type::eof();
+            }
+
+            if (!run_once(lock, until))
+                return traits_type::eof();
+        }
+    }
+
+    int_type overflow(int_type c) override
+    {
+        if (deadline_.expired())
+            return traits_type::eof();
+
+        auto const until = deadline_.next();
+        std::unique_lock<std::mutex> lock{mutex_};
+
+        if (!complete_write(lock, until))
+            return traits_type::eof();
+
+        if (pptr() != pbase())
+        {
+            queue_send(false);
+            if (!complete_write(lock, until))
+                return traits_type::eof();
+        }
+
+        setp(std::data(write_buffer_), std::data(write_buffer_) + std::size(write_buffer_));
+
+        if (!traits_type::eq_int_type(c, traits_type::eof()))
+        {
+            *pptr() = traits_type::to_char_type(c);
+            pbump(1);
+        }
+
+        return traits_type::not_eof(c);
+    }
+
+    // The send is queued along with a linked receive of the reply and goes
+    // to the kernel with the next wait on the ring (see uring::submit),
+    // a flush doesn't wait for them.
+    int sync() override
+    {
+        if (pptr() == pbase())
+            return 0;
+        if (deadline_.expired())
+            return -1;
+        auto const until = deadline_.next();
+        std::unique_lock<std::mutex> lock{mutex_};
+        if (!complete_write(lock, until))
+            return -1;
+        queue_send(!read_pending_ && !buffered_);
+        if (auto ec = ring_->submit())
+        {
+            error_ = ec;
+            return -1;
+        }
+        return 0;
+    }
+
+private:
+    std::shared_ptr<uring> ring_;
+    int fd_;
+    std::error_code &error_;
+    detail::deadline &deadline_;
+
+    std::unique_ptr<uring::buffer> read_buffer_;
+    uring::operation read_op_;
+    bool read_pending_ = false;
+
+    std::vector<char> write_buffer_;
+    uring::operation write_op_;
+    bool write_pending_ = false;
+    char const *write_data_ = nullptr;
+    std::size_t write_size_ = 0;
+
+    uring::operation cancel_read_op_;
+    uring::operation cancel_write_op_;
+
+    // One thread can read while another one writes. The get and put areas
+    // belong to their threads, the operations' state is guarded by the mutex.
+    std::mutex mutex_;
+    // The get area may have unread data, a receive can't be queued into it.
+    bool buffered_ = false;
+
+    bool run_once(deadline::clock::time_point until)
+    {
+        if (auto ec = ring_->run_once(until))
+        {
+            fail(ec);
+            return false;
+        }
+        return true;
+    }
+
+    bool run_once(std::unique_lock<std::mutex> &lock, deadline::clock::time_point until)
+    {
+        lock.unlock();
+        auto const ec = ring_->run_once(until);
+        lock.lock();
+        if (ec)
+        {
+            fail(ec);
+            return false;
+        }
+        return true;
+    }
+
+    // The operation which missed its deadline stays pending in the ring,
+    // its result is never taken.
+    void fail(std::error_code const &ec)
+    {
+        if (ec == std::errc::timed_out)
+            deadline_.expire();
+        error_ = ec;
+    }
+
+    void queue_receive()
+    {
+        read_pending_ = true;
+        ring_->receive(fd_, *read_buffer_, read_op_);
+    }
+
+    void queue_send(bool with_receive)
+    {
+        write_data_ = pbase();
+        write_size_ = static_cast<std::size_t>(pptr() - pbase());
+        write_pending_ = true;
+        ring_->send(fd_, write_data_, write_size_, write_op_, with_receive);
+        if (with_receive)
+            queue_receive();
+        // The data is owned by the kernel until the send is completed.
+        setp(pptr(), pptr());
+    }
+
+    // Handles a completed send, a short one is continued.
+    bool check_write()
+    {
+        if (!write_pending_ || !write_op_.done.load(std::memory_order_acquire))
+            return true;
+
+        auto const result = write_op_.result;
+        if (result < 0 && result != -EINTR && result != -EAGAIN)
+        {
+            write_pending_ = false;
+            error_ = std::error_code{-result, std::system_category()};
+            return false;
+        }
+
+        auto const sent = static_cast<std::size_t>(std::max(result, 0));
+        if (sent < write_size_)
+        {
+            write_data_ += sent;
+            write_size_ -= sent;
+            ring_->send(fd_, write_data_, write_size_, write_op_, false);
+            return true;
+        }
+
+        write_pending_ = false;
+        return true;
+    }
+
+    bool complete_write(deadline::clock::time_point until)
+    {
+        while (write_pending_)
+        {
+            if (!check_write())
+                return false;
+            if (write_pending_ && !write_op_.done.load(std::memory_order_acquire) &&
+                    !run_once(until))
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    bool complete_write(std::unique_lock<std::mutex> &lock, deadline::clock::time_point until)
+    {
+        while (write_pending_)
+        {
+            if (!check_write())
+                return false;
+            if (write_pending_ && !write_op_.done.load(std::memory_order_acquire) &&
+                    !run_once(lock, until))
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+};
+
+class uring_stream final
+    : public std::iostream
+{
+public:
+    uring_stream(std::shared_ptr<uring> ring, int fd,
+            std::size_t read_buffer_size = 0, std::size_t write_buffer_size = 0)
+        : std::iostream{nullptr}
+        , buffer_{std::move(ring), fd, error_, deadline_, read_buffer_size, write_buffer_size}
+    {
+        rdbuf(&buffer_);
+    }
+
+    [[nodiscard]]
+    std::error_code const& error() const noexcept
+    {
+        return error_;
+    }
+
+    [[nodiscard]]
+    detail::deadline& deadline() noexcept
+    {
+        return deadline_;
+    }
+
+    [[nodiscard]]
+    bool readable()
+    {
+        return buffer_.readable();
+    }
+
+    [[nodiscard]]
+    uring& ring() noexcept
+    {
+        return buffer_.ring();
+    }
+
+    [[nodiscard]]
+    int native_handle() const noexcept
+    {
+        return buffer_.native_handle();
+    }
+
+private:
+    std::error_code error_;
+    detail::deadline deadline_;
+    uring_streambuf buffer_;
+};
+
+}   // namespace detail
+}   // namespace rediscpp
+
+#endif  // !REDISCPP_IO_URING && __linux__
+
+#endif  // !REDISCPP_DETAIL_URING_HPP_
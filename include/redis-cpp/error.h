@@ -0,0 +1,292 @@
+//-------------------------------------------------------------------
+//  redis-cpp
+//  https://github.com/tdv/redis-cpp
+//  Created:     10.2026
+//  Copyright 2020 Dmitry Tkachenko (tkachenkodmitryv@gmail.com)
+//  Distributed under the MIT License
+//  (See accompanying file LICENSE)
+//-------------------------------------------------------------------
+
+#ifndef REDISCPP_ERROR_H_
+#define REDISCPP_ERROR_H_
+
+// STD
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <type_traits>
+#include <typeinfo>
+#include <utility>
+#include <variant>
+
+// REDIS-CPP
+#include <redis-cpp/detail/config.h>
+
+namespace rediscpp
+{
+
+enum class errc
+{
+    empty_value = 1,
+    server_error,
+    wrong_type,
+    no_script,
+    null_value,
+    type_mismatch,
+    bad_format,
+    io_error
+};
+
+}   // namespace rediscpp
+
+namespace std
+{
+
+template <>
+struct is_error_code_enum<rediscpp::errc>
+    : public true_type
+{
+};
+
+}   // namespace std
+
+namespace rediscpp
+{
+
+namespace detail
+{
+
+class error_category final
+    : public std::error_category
+{
+public:
+    char const* name() const noexcept override
+    {
+        return "rediscpp";
+    }
+
+    std::string message(int code) const override
+    {
+        switch (static_cast<errc>(code))
+        {
+        case errc::empty_value :
+            return "Empty value.";
+        case errc::server_error :
+            return "Server error.";
+        case errc::wrong_type :
+            return "Operation against a key holding the wrong kind of value.";
+        case errc::no_script :
+            return "No matching script.";
+        case errc::null_value :
+            return "You can't cast Null to a type.";
+        case errc::type_mismatch :
+            return "Type mismatch.";
+        case errc::bad_format :
+            return "Bad input format.";
+        case errc::io_error :
+            return "Stream error.";
+        default :
+            break;
+        }
+        return "Unknown error.";
+    }
+};
+
+}   // namespace detail
+
+[[nodiscard]]
+inline std::error_category const& error_category() noexcept
+{
+    static detail::error_category const category;
+    return category;
+}
+
+[[nodiscard]]
+inline std::error_code make_error_code(errc code) noexcept
+{
+    return {static_cast<int>(code), error_category()};
+}
+
+[[nodiscard]]
+inline errc server_error_code(std::string_view message) noexcept
+{
+    auto starts_with = [message] (std::string_view prefix)
+        {
+            return message.substr(0, std::size(prefix)) == prefix;
+        };
+
+    if (starts_with("WRONGTYPE"))
+        return errc::wrong_type;
+    if (starts_with("NOSCRIPT"))
+        return errc::no_script;
+    return errc::server_error;
+}
+
+class error final
+{
+public:
+    error() = default;
+
+    error(std::error_code code, std::string message = {})
+        : code_{std::move(code)}
+        , message_{std::move(message)}
+    {
+    }
+
+    explicit operator bool () const noexcept
+    {
+        return static_cast<bool>(code_);
+    }
+
+    [[nodiscard]]
+    std::error_code const& code() const noexcept
+    {
+        return code_;
+    }
+
+    // A server error message or an empty string for client side errors.
+    [[nodiscard]]
+    std::string_view message() const noexcept
+    {
+        return message_;
+    }
+
+    [[noreturn]]
+    void raise() const
+    {
+        switch (static_cast<errc>(code_.category() == error_category() ? code_.value() : 0))
+        {
+        case errc::empty_value :
+            throw std::runtime_error{"Empty value."};
+        case errc::server_error :
+        case errc::wrong_type :
+        case errc::no_script :
+            throw std::runtime_error{message_};
+        case errc::null_value :
+            throw std::logic_error{"You can't cast Null to a type."};
+        case errc::type_mismatch :
+            throw std::bad_cast{};
+        case errc::bad_format :
+            throw std::invalid_argument{message_.empty() ? code_.message() : message_};
+        default :
+            break;
+        }
+        throw std::system_error{code_, message_};
+    }
+
+private:
+    std::error_code code_;
+    std::string message_;
+};
+
+template <typename T>
+class result final
+{
+public:
+    result(T value)
+        : data_{std::in_place_index<0>, std::move(value)}
+    {
+    }
+
+    result(rediscpp::error err)
+        : data_{std::in_place_index<1>, std::move(err)}
+    {
+    }
+
+    result(errc code)
+        : data_{std::in_place_index<1>, make_error_code(code)}
+    {
+    }
+
+    [[nodiscard]]
+    bool has_value() const noexcept
+    {
+        return data_.index() == 0;
+    }
+
+    explicit operator bool () const noexcept
+    {
+        return has_value();
+    }
+
+    [[nodiscard]]
+    T& value() &
+    {
+        check();
+        return *std::get_if<0>(&data_);
+    }
+
+    [[nodiscard]]
+    T const& value() const &
+    {
+        check();
+        return *std::get_if<0>(&data_);
+    }
+
+    [[nodiscard]]
+    T&& value() &&
+    {
+        check();
+        return std::move(*std::get_if<0>(&data_));
+    }
+
+    template <typename U>
+    [[nodiscard]]
+    T value_or(U &&default_value) const &
+    {
+        return has_value() ? *std::get_if<0>(&data_) :
+                static_cast<T>(std::forward<U>(default_value));
+    }
+
+    [[nodiscard]]
+    T& operator * () & noexcept
+    {
+        return *std::get_if<0>(&data_);
+    }
+
+    [[nodiscard]]
+    T const& operator * () const & noexcept
+    {
+        return *std::get_if<0>(&data_);
+    }
+
+    [[nodiscard]]
+    T* operator -> () noexcept
+    {
+        return std::get_if<0>(&data_);
+    }
+
+    [[nodiscard]]
+    T const* operator -> () const noexcept
+    {
+        return std::get_if<0>(&data_);
+    }
+
+    [[nodiscard]]
+    rediscpp::error const& error() const noexcept
+    {
+        static rediscpp::error const no_error;
+        auto const *err = std::get_if<1>(&data_);
+        return err ? *err : no_error;
+    }
+
+    [[nodiscard]]
+    std::error_code const& code() const noexcept
+    {
+        return error().code();
+    }
+
+private:
+    std::variant<T, rediscpp::error> data_;
+
+    void check() const
+    {
+        if (!has_value())
+            error().raise();
+    }
+};
+
+}   // namespace rediscpp
+
+#endif  // !REDISCPP_ERROR_H_
@@ -17,6 +17,8 @@
 
 // REDIS-CPP
 #include <redis-cpp/detail/config.h>
+#include <redis-cpp/error.h>
+#include <redis-cpp/resp/decoding.h>
 #include <redis-cpp/resp/serialization.h>
 #include <redis-cpp/value.h>
 
@@ -46,6 +48,36 @@ inline auto execute(std::iostream &stream, std::string_view name, TArgs && ... a
     return value{stream};
 }
 
+template <typename T, typename ... TArgs>
+[[nodiscard]]
+inline T execute_as(std::iostream &stream, std::string_view name, TArgs && ... args)
+{
+    execute_no_flush(stream, std::move(name), std::forward<TArgs>(args) ... );
+    std::flush(stream);
+    return resp::decoding::decode<T>(stream);
+}
+
+// Doesn't throw on a server error, Null, a type mismatch or a broken stream.
+template <typename T, typename ... TArgs>
+[[nodiscard]]
+inline result<T> try_execute_as(std::iostream &stream, std::string_view name, TArgs && ... args)
+{
+    execute_no_flush(stream, std::move(name), std::forward<TArgs>(args) ... );
+    std::flush(stream);
+    if (!stream)
+        return errc::io_error;
+    return resp::decoding::try_decode<T>(stream);
+}
+
+template <typename ... TArgs>
+[[nodiscard]]
+inline result<value> try_execute(std::iostream &stream, std::string_view name, TArgs && ... args)
+{
+    execute_no_flush(stream, std::move(name), std::forward<TArgs>(args) ... );
+    std::flush(stream);
+    return value::try_read(stream);
+}
+
 }   // namespace rediscpp
 
 #endif  // !REDISCPP_EXECUTE_H__
@@ -0,0 +1,355 @@
+//-------------------------------------------------------------------
+//  redis-cpp
+//  https://github.com/tdv/redis-cpp
+//  Created:     10.2026
+//  Copyright 2020 Dmitry Tkachenko (tkachenkodmitryv@gmail.com)
+//  Distributed under the MIT License
+//  (See accompanying file LICENSE)
+//-------------------------------------------------------------------
+
+#ifndef REDISCPP_HASH_H_
+#define REDISCPP_HASH_H_
+
+// STD
+#include <array>
+#include <charconv>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <iterator>
+#include <limits>
+#include <optional>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+// REDIS-CPP
+#include <redis-cpp/detail/config.h>
+#include <redis-cpp/error.h>
+#include <redis-cpp/execute.h>
+#include <redis-cpp/resp/decoding.h>
+#include <redis-cpp/resp/serialization.h>
+
+namespace rediscpp
+{
+
+// Maps a user type to the fields of a hash by its struct_traits, which have
+// the member pointers and the names of the fields:
+//   template <>
+//   struct rediscpp::resp::decoding::struct_traits<user>
+//   {
+//       static constexpr auto members = std::make_tuple(&user::name, &user::age);
+//       static constexpr std::string_view names[] = {"name", "age"};
+//   };
+// The members are strings (anything convertible into std::string_view),
+// integers, bool, floating point numbers or std::optional of them. An empty
+// optional isn't written. The commands are written right from the members:
+// the names are encoded at compile time and the numbers are formatted with
+// std::to_chars on the stack, so there is no intermediate map or string.
+template <typename T>
+class struct_hash final
+{
+public:
+    using traits = resp::decoding::struct_traits<T>;
+
+    static constexpr std::size_t count = std::tuple_size_v<
+            resp::detail::decoding::decay_t<decltype(traits::members)>>;
+
+    static_assert(std::size(traits::names) == count,
+            "[rediscpp::struct_hash] Each member has to have a name.");
+
+    // HSET key name1 value1 name2 value2 ...
+    // HSET needs a field, so nothing is written and false is returned
+    // if all the members are empty optionals.
+    static bool put_hset(std::ostream &stream, std::string_view key, T const &object)
+    {
+        auto const fields = present(object, sequence{});
+        if (!fields)
+            return false;
+        put(stream, resp::serialization::array_header{2 + 2 * fields});
+        stream.write("$4\r\nhset\r\n", 10);
+        put_bulk(stream, key);
+        put_fields(stream, object, sequence{});
+        return true;
+    }
+
+    // HMGET key name1 name2 ..., the reply is decoded into T by position.
+    static void put_hmget(std::ostream &stream, std::string_view key)
+    {
+        put(stream, resp::serialization::array_header{2 + count});
+        stream.write("$5\r\nhmget\r\n", 11);
+        put_bulk(stream, key);
+        put_names(stream, sequence{});
+    }
+
+    // Decodes the reply of HGETALL by the names of the fields. The unknown
+    // fields are skipped and the missing ones keep their values, a missing
+    // key (an empty reply) is Null.
+    static bool get(std::istream &stream, resp::decoding::header &hdr, T &result, error &err)
+    {
+        if (hdr.mark() != resp::detail::marker::array || hdr.is_null() || hdr.length() % 2)
+            return resp::detail::decoding::unexpected(stream, hdr, err);
+        if (!hdr.length())
+        {
+            err = make_error_code(errc::null_value);
+            return false;
+        }
+
+        std::string name;
+        auto field = count;
+        return resp::detail::decoding::for_each_item(stream, hdr.length(), err,
+                [&stream, &result, &err, &name, &field] (resp::decoding::header &item, std::size_t index)
+                {
+                    if (index % 2 == 0)
+                    {
+                        field = count;
+                        if (!resp::decoding::get(stream, item, name, err))
+                            return false;
+                        field = find(name, sequence{});
+                        return true;
+                    }
+                    if (field == count)
+                        return resp::detail::decoding::skip(stream, item, err);
+                    return set(stream, item, result, err, field, sequence{});
+                }
+            );
+    }
+
+private:
+    using sequence = std::make_index_sequence<count>;
+
+    template <typename TField>
+    struct is_optional
+        : std::false_type
+    {
+    };
+
+    template <typename TField>
+    struct is_optional<std::optional<TField>>
+        : std::true_type
+    {
+    };
+
+    template <std::size_t I>
+    using member_type = resp::detail::decoding::decay_t<
+            decltype(std::declval<T const &>().*std::get<I>(traits::members))>;
+
+    static constexpr std::size_t digits(std::size_t value) noexcept
+    {
+        std::size_t res = 1;
+        for ( ; value >= 10 ; value /= 10)
+            ++res;
+        return res;
+    }
+
+    // The name as a bulk string: $<length>\r\n<name>\r\n
+    template <std::size_t I>
+    static constexpr auto encode_name() noexcept
+    {
+        constexpr std::string_view name = traits::names[I];
+        constexpr auto length = digits(std::size(name));
+        std::array<char, 1 + length + 2 + std::size(name) + 2> res{};
+        std::size_t pos = 0;
+        res[pos++] = resp::detail::marker::bulk_string;
+        for (std::size_t i = length, value = std::size(name) ; i > 0 ; --i, value /= 10)
+            res[pos + i - 1] = static_cast<char>('0' + value % 10);
+        pos += length;
+        res[pos++] = resp::detail::marker::cr;
+        res[pos++] = resp::detail::marker::lf;
+        for (auto c : name)
+            res[pos++] = c;
+        res[pos++] = resp::detail::marker::cr;
+        res[pos++] = resp::detail::marker::lf;
+        return res;
+    }
+
+    template <std::size_t I>
+    static constexpr auto encoded_name = encode_name<I>();
+
+    template <std::size_t ... I>
+    static std::size_t present(T const &object, std::index_sequence<I ... >)
+    {
+        return (std::size_t{0} + ... + is_present(object.*std::get<I>(traits::members)));
+    }
+
+    template <typename TField>
+    static bool is_present(TField const &value) noexcept
+    {
+        if constexpr (is_optional<TField>::value)
+            return value.has_value();
+        else
+            return true;
+    }
+
+    template <std::size_t ... I>
+    static void put_fields(std::ostream &stream, T const &object, std::index_sequence<I ... >)
+    {
+        (put_field<I>(stream, object.*std::get<I>(traits::members)), ... );
+    }
+
+    template <std::size_t I, typename TField>
+    static void put_field(std::ostream &stream, TField const &value)
+    {
+        if constexpr (is_optional<TField>::value)
+        {
+            if (value)
+                put_field<I>(stream, *value);
+        }
+        else
+        {
+            stream.write(std::data(encoded_name<I>), std::size(encoded_name<I>));
+            put_value(stream, value);
+        }
+    }
+
+    template <std::size_t ... I>
+    static void put_names(std::ostream &stream, std::index_sequence<I ... >)
+    {
+        (stream.write(std::data(encoded_name<I>), std::size(encoded_name<I>)), ... );
+    }
+
+    template <typename TField>
+    static void put_value(std::ostream &stream, TField const &value)
+    {
+        if constexpr (std::is_same_v<TField, bool>)
+        {
+            put_bulk(stream, value ? "1" : "0");
+        }
+        else if constexpr (std::is_integral_v<TField>)
+        {
+            char buffer[std::numeric_limits<TField>::digits10 + 3];
+            auto const res = std::to_chars(std::begin(buffer), std::end(buffer), value);
+            put_bulk(stream, std::string_view{buffer, static_cast<std::size_t>(res.ptr - buffer)});
+        }
+        else if constexpr (std::is_floating_point_v<TField>)
+        {
+            char buffer[64];
+#ifdef __cpp_lib_to_chars
+            // The shortest form which is read back as the same value.
+            auto const res = std::to_chars(std::begin(buffer), std::end(buffer), value);
+            put_bulk(stream, std::string_view{buffer, static_cast<std::size_t>(res.ptr - buffer)});
+#else
+            auto const size = std::snprintf(buffer, sizeof(buffer), "%.*Lg",
+                    std::numeric_limits<TField>::max_digits10, static_cast<long double>(value));
+            put_bulk(stream, std::string_view{buffer, static_cast<std::size_t>(size)});
+#endif
+        }
+        else
+        {
+            static_assert(std::is_convertible_v<TField const &, std::string_view>,
+                    "[rediscpp::struct_hash] A member has to be a number, bool, "
+                    "a string or std::optional of them.");
+            put_bulk(stream, std::string_view{value});
+        }
+    }
+
+    static void put_bulk(std::ostream &stream, std::string_view value)
+    {
+        char header[24];
+        auto *pos = header;
+        *pos++ = resp::detail::marker::bulk_string;
+        pos = std::to_chars(pos, std::end(header), std::size(value)).ptr;
+        *pos++ = resp::detail::marker::cr;
+        *pos++ = resp::detail::marker::lf;
+        stream.write(header, pos - header);
+        stream.write(std::data(value), static_cast<std::streamsize>(std::size(value)));
+        stream.write("\r\n", 2);
+    }
+
+    template <std::size_t ... I>
+    static std::size_t find(std::string_view name, std::index_sequence<I ... >) noexcept
+    {
+        auto res = count;
+        ((name == traits::names[I] ? (res = I, true) : false) || ... );
+        return res;
+    }
+
+    template <std::size_t ... I>
+    static bool set(std::istream &stream, resp::decoding::header &hdr, T &result,
+            error &err, std::size_t index, std::index_sequence<I ... >)
+    {
+        return ((I == index ? resp::decoding::get(stream, hdr,
+                result.*std::get<I>(traits::members), err) : false) || ... );
+    }
+};
+
+// Writes HSET of all the fields, e.g. into a pipeline or the batch of a loader.
+// Returns false if there is no field to set, then there is no command
+// and no reply to it.
+template <typename T>
+inline bool hset_struct_no_flush(std::ostream &stream, std::string_view key, T const &object)
+{
+    return struct_hash<T>::put_hset(stream, key, object);
+}
+
+// Returns the number of the fields which have been added, it's zero
+// with no round trip if there is no field to set.
+template <typename T>
+[[nodiscard]]
+inline result<std::int64_t> try_hset_struct(std::iostream &stream, std::string_view key, T const &object)
+{
+    if (!hset_struct_no_flush(stream, key, object))
+        return std::int64_t{0};
+    std::flush(stream);
+    if (!stream)
+        return errc::io_error;
+    return resp::decoding::try_decode<std::int64_t>(stream);
+}
+
+template <typename T>
+inline std::int64_t hset_struct(std::iostream &stream, std::string_view key, T const &object)
+{
+    return try_hset_struct(stream, key, object).value();
+}
+
+// HMGET of all the fields, a missing field is Null unless its member is optional.
+template <typename T>
+[[nodiscard]]
+inline result<T> try_hmget_struct(std::iostream &stream, std::string_view key)
+{
+    struct_hash<T>::put_hmget(stream, key);
+    std::flush(stream);
+    if (!stream)
+        return errc::io_error;
+    return resp::decoding::try_decode<T>(stream);
+}
+
+template <typename T>
+[[nodiscard]]
+inline T hmget_struct(std::iostream &stream, std::string_view key)
+{
+    return try_hmget_struct<T>(stream, key).value();
+}
+
+// HGETALL, the fields are matched by their names.
+template <typename T>
+[[nodiscard]]
+inline result<T> try_hgetall_struct(std::iostream &stream, std::string_view key)
+{
+    execute_no_flush(stream, "hgetall", key);
+    std::flush(stream);
+    if (!stream)
+        return errc::io_error;
+    error err;
+    resp::decoding::header hdr;
+    if (!hdr.read(stream, err))
+        return err;
+    T value{};
+    if (!struct_hash<T>::get(stream, hdr, value, err))
+        return err;
+    return value;
+}
+
+template <typename T>
+[[nodiscard]]
+inline T hgetall_struct(std::iostream &stream, std::string_view key)
+{
+    return try_hgetall_struct<T>(stream, key).value();
+}
+
+}   // namespace rediscpp
+
+#endif  // !REDISCPP_HASH_H_
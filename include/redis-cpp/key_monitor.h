@@ -0,0 +1,471 @@
+//-------------------------------------------------------------------
+//  redis-cpp
+//  https://github.com/tdv/redis-cpp
+//  Created:     10.2026
+//  Copyright 2020 Dmitry Tkachenko (tkachenkodmitryv@gmail.com)
+//  Distributed under the MIT License
+//  (See accompanying file LICENSE)
+//-------------------------------------------------------------------
+
+#ifndef REDISCPP_KEY_MONITOR_H_
+#define REDISCPP_KEY_MONITOR_H_
+
+// STD
+#include <algorithm>
+#include <charconv>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <deque>
+#include <functional>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+// REDIS-CPP
+#include <redis-cpp/detail/config.h>
+#include <redis-cpp/tap.h>
+
+namespace rediscpp
+{
+
+struct key_monitor_options final
+{
+    // One command of so many is sampled at random, the counts are scaled back.
+    std::size_t sample_every = 8;
+    // The number of the hottest and of the biggest keys which are kept.
+    std::size_t top = 32;
+    // The count-min sketch: rows and counters in a row.
+    std::size_t depth = 4;
+    std::size_t width = 4096;
+    // Longer keys are truncated.
+    std::size_t max_key_size = 256;
+};
+
+struct key_sample final
+{
+    std::string key;
+    // The estimated number of the commands.
+    std::uint64_t count = 0;
+    // The largest command and reply in bytes as they're sent and received.
+    std::uint64_t request_bytes = 0;
+    std::uint64_t reply_bytes = 0;
+};
+
+struct key_report final
+{
+    std::uint64_t sampled = 0;
+    // The most used keys go first.
+    std::vector<key_sample> hot;
+    // The keys with the largest commands or replies go first.
+    std::vector<key_sample> big;
+};
+
+// Counts the commands per key with a count-min sketch and keeps the hottest
+// and the biggest keys, so the memory doesn't depend on the number of keys.
+// The samples come from the streams made by monitor_stream, a monitor can
+// be shared by several streams. It's thread-safe.
+class key_monitor final
+{
+public:
+    explicit key_monitor(key_monitor_options const &options = {})
+        : options_{options}
+        , counters_(std::max<std::size_t>(options_.depth, 1) * std::max<std::size_t>(options_.width, 1))
+        , hot_{options_.top}
+        , big_{options_.top}
+    {
+        options_.sample_every = std::max<std::size_t>(options_.sample_every, 1);
+        options_.depth = std::max<std::size_t>(options_.depth, 1);
+        options_.width = std::max<std::size_t>(options_.width, 1);
+    }
+
+    key_monitor(key_monitor const &) = delete;
+    key_monitor& operator = (key_monitor const &) = delete;
+
+    [[nodiscard]]
+    key_monitor_options const& options() const noexcept
+    {
+        return options_;
+    }
+
+    // A sampled command of the key with the sizes of the command and its reply.
+    void record(std::string_view key, std::uint64_t request_bytes, std::uint64_t reply_bytes)
+    {
+        key = key.substr(0, options_.max_key_size);
+        std::lock_guard<std::mutex> lock{mutex_};
+        ++sampled_;
+        auto const count = count_key(key) * options_.sample_every;
+        hot_.update(key, count, count, request_bytes, reply_bytes);
+        big_.update(key, std::max(request_bytes, reply_bytes), count, request_bytes, reply_bytes);
+    }
+
+    [[nodiscard]]
+    key_report snapshot() const
+    {
+        std::lock_guard<std::mutex> lock{mutex_};
+        key_report res;
+        res.sampled = sampled_;
+        res.hot = hot_.items();
+        std::sort(std::begin(res.hot), std::end(res.hot),
+                [] (key_sample const &a, key_sample const &b) { return a.count > b.count; });
+        res.big = big_.items();
+        std::sort(std::begin(res.big), std::end(res.big),
+                [] (key_sample const &a, key_sample const &b)
+                {
+                    return std::max(a.request_bytes, a.reply_bytes) > std::max(b.request_bytes, b.reply_bytes);
+                }
+            );
+        return res;
+    }
+
+    // Starts a new window.
+    void reset()
+    {
+        std::lock_guard<std::mutex> lock{mutex_};
+        sampled_ = 0;
+        std::fill(std::begin(counters_), std::end(counters_), 0);
+        hot_.clear();
+        big_.clear();
+    }
+
+private:
+    // A min-heap of at most `size` keys by their score with an index,
+    // so a key's score is raised in place. The scores only grow.
+    class top_keys final
+    {
+    public:
+        explicit top_keys(std::size_t size)
+            : size_{size}
+        {
+        }
+
+        void update(std::string_view key, std::uint64_t score, std::uint64_t count,
+                std::uint64_t request_bytes, std::uint64_t reply_bytes)
+        {
+            if (!size_)
+                return;
+            std::string name{key};
+            if (auto iter = index_.find(name) ; iter != std::end(index_))
+            {
+                auto &item = heap_[iter->second];
+                item.score = std::max(item.score, score);
+                item.sample.count = std::max(item.sample.count, count);
+                item.sample.request_bytes = std::max(item.sample.request_bytes, request_bytes);
+                item.sample.reply_bytes = std::max(item.sample.reply_bytes, reply_bytes);
+                sift_down(iter->second);
+                return;
+            }
+
+            entry item{score, {name, count, request_bytes, reply_bytes}};
+            if (std::size(heap_) < size_)
+            {
+                heap_.push_back(std::move(item));
+                index_[std::move(name)] = std::size(heap_) - 1;
+                sift_up(std::size(heap_) - 1);
+                return;
+            }
+            if (score <= heap_.front().score)
+                return;
+            index_.erase(heap_.front().sample.key);
+            heap_.front() = std::move(item);
+            index_[std::move(name)] = 0;
+            sift_down(0);
+        }
+
+        [[nodiscard]]
+        std::vector<key_sample> items() const
+        {
+            std::vector<key_sample> res;
+            res.reserve(std::size(heap_));
+            for (auto const &item : heap_)
+                res.push_back(item.sample);
+            return res;
+        }
+
+        void clear() noexcept
+        {
+            heap_.clear();
+            index_.clear();
+        }
+
+    private:
+        struct entry final
+        {
+            std::uint64_t score;
+            key_sample sample;
+        };
+
+        std::size_t const size_;
+        std::vector<entry> heap_;
+        std::unordered_map<std::string, std::size_t> index_;
+
+        void swap_items(std::size_t a, std::size_t b)
+        {
+            std::swap(heap_[a], heap_[b]);
+            index_[heap_[a].sample.key] = a;
+            index_[heap_[b].sample.key] = b;
+        }
+
+        void sift_up(std::size_t pos)
+        {
+            while (pos && heap_[pos].score < heap_[(pos - 1) / 2].score)
+            {
+                swap_items(pos, (pos - 1) / 2);
+                pos = (pos - 1) / 2;
+            }
+        }
+
+        void sift_down(std::size_t pos)
+        {
+            for ( ; ; )
+            {
+                auto least = pos;
+                for (auto child : {pos * 2 + 1, pos * 2 + 2})
+                {
+                    if (child < std::size(heap_) && heap_[child].score < heap_[least].score)
+                        least = child;
+                }
+                if (least == pos)
+                    return;
+                swap_items(pos, least);
+                pos = least;
+            }
+        }
+    };
+
+    key_monitor_options options_;
+    mutable std::mutex mutex_;
+    std::uint64_t sampled_ = 0;
+    std::vector<std::uint32_t> counters_;
+    top_keys hot_;
+    top_keys big_;
+
+    // Adds the key to the sketch and returns its estimate. The rows are
+    // indexed by h1 + i * h2 of one hash.
+    std::uint64_t count_key(std::string_view key) noexcept
+    {
+        std::uint64_t const hash = std::hash<std::string_view>{}(key);
+        auto const h1 = hash & 0xFFFFFFFF;
+        auto const h2 = (hash >> 32) | 1;
+        auto estimate = ~std::uint32_t{0};
+        for (std::size_t row = 0 ; row < options_.depth ; ++row)
+        {
+            auto &counter = counters_[row * options_.width + (h1 + row * h2) % options_.width];
+            if (counter != ~std::uint32_t{0})
+                ++counter;
+            estimate = std::min(estimate, counter);
+        }
+        return estimate;
+    }
+};
+
+// The observer of tapped_stream which parses the commands and the replies
+// as they pass, to take the key and the sizes of the sampled commands.
+// The key is the first argument after the name of the command. The replies
+// are matched to the commands in order, so the stream isn't for Pub/Sub.
+class key_sampler final
+{
+public:
+    explicit key_sampler(std::shared_ptr<key_monitor> monitor)
+        : monitor_{std::move(monitor)}
+        , sample_every_{monitor_->options().sample_every}
+        , max_key_size_{monitor_->options().max_key_size}
+    {
+    }
+
+    void sent(char const *data, std::size_t size)
+    {
+        request_bytes_ += size;
+        while (size)
+        {
+            if (out_in_payload_)
+            {
+                auto const part = static_cast<std::size_t>(std::min<std::uint64_t>(out_payload_, size));
+                if (sampled_ && out_arg_ == 1 && out_payload_ > 2)
+                {
+                    auto const bytes = std::min<std::uint64_t>(part, out_payload_ - 2);
+                    if (std::size(key_) < max_key_size_)
+                        key_.append(data, std::min<std::size_t>(bytes, max_key_size_ - std::size(key_)));
+                }
+                data += part;
+                size -= part;
+                if (out_payload_ -= part)
+                    continue;
+                out_in_payload_ = false;
+                if (++out_arg_ == out_args_)
+                    command_sent(request_bytes_ - size);
+                continue;
+            }
+
+            if (!take_line(out_line_, data, size))
+                continue;
+            if (out_line_[0] == '*')
+            {
+                // Not each n-th one, it could fall on the same command of a loop.
+                sampled_ = random_() % sample_every_ == 0;
+                ++commands_;
+                key_.clear();
+                out_args_ = static_cast<std::size_t>(number(out_line_));
+                out_arg_ = 0;
+                if (!out_args_)
+                    command_sent(request_bytes_ - size);
+            }
+            else if (out_line_[0] == '$')
+            {
+                // The payload and its CRLF.
+                out_payload_ = static_cast<std::uint64_t>(number(out_line_)) + 2;
+                out_in_payload_ = true;
+            }
+            out_line_.clear();
+        }
+    }
+
+    void received(char const *data, std::size_t size)
+    {
+        reply_bytes_ += size;
+        while (size)
+        {
+            if (in_in_payload_)
+            {
+                auto const part = static_cast<std::size_t>(std::min<std::uint64_t>(in_payload_, size));
+                data += part;
+                size -= part;
+                if (in_payload_ -= part)
+                    continue;
+                in_in_payload_ = false;
+                item_received(size);
+                continue;
+            }
+
+            if (!take_line(in_line_, data, size))
+                continue;
+            auto const mark = in_line_[0];
+            auto const length = mark == '$' || mark == '*' ? number(in_line_) : 0;
+            in_line_.clear();
+            if (mark == '$' && length >= 0)
+            {
+                in_payload_ = static_cast<std::uint64_t>(length) + 2;
+                in_in_payload_ = true;
+            }
+            else if (mark == '*' && length > 0)
+            {
+                nested_.push_back(length);
+            }
+            else
+            {
+                item_received(size);
+            }
+        }
+    }
+
+private:
+    struct pending final
+    {
+        std::uint64_t command;
+        std::string key;
+        std::uint64_t request_bytes;
+    };
+
+    std::shared_ptr<key_monitor> monitor_;
+    std::size_t const sample_every_;
+    std::size_t const max_key_size_;
+
+    // The commands being sent.
+    std::string out_line_;
+    std::size_t out_args_ = 0;
+    std::size_t out_arg_ = 0;
+    std::uint64_t out_payload_ = 0;
+    bool out_in_payload_ = false;
+    std::uint64_t request_bytes_ = 0;
+    std::uint64_t commands_ = 0;
+    std::minstd_rand random_{std::random_device{}()};
+    bool sampled_ = false;
+    std::string key_;
+
+    // The replies being received, the items left in the nested arrays.
+    std::string in_line_;
+    std::uint64_t in_payload_ = 0;
+    bool in_in_payload_ = false;
+    std::vector<std::int64_t> nested_;
+    std::uint64_t reply_bytes_ = 0;
+    std::uint64_t replies_ = 0;
+
+    std::mutex mutex_;
+    std::deque<pending> pending_;
+
+    static std::int64_t number(std::string const &line) noexcept
+    {
+        std::int64_t res = 0;
+        std::from_chars(std::data(line) + 1, std::data(line) + std::size(line), res);
+        return res;
+    }
+
+    // Takes a line up to '\n', false if it isn't complete yet.
+    static bool take_line(std::string &line, char const *&data, std::size_t &size)
+    {
+        auto const *end = static_cast<char const *>(std::memchr(data, '\n', size));
+        auto const length = end ? static_cast<std::size_t>(end - data) + 1 : size;
+        line.append(data, length);
+        data += length;
+        size -= length;
+        return end != nullptr;
+    }
+
+    void command_sent(std::uint64_t bytes)
+    {
+        auto const command = commands_ - 1;
+        if (sampled_ && out_args_ > 1)
+        {
+            std::lock_guard<std::mutex> lock{mutex_};
+            pending_.push_back({command, key_, bytes});
+        }
+        // The bytes of the next command are counted from zero.
+        request_bytes_ -= bytes;
+    }
+
+    // `left` bytes of the chunk belong to the next replies.
+    void item_received(std::size_t left)
+    {
+        while (!nested_.empty())
+        {
+            if (--nested_.back())
+                return;
+            nested_.pop_back();
+        }
+
+        auto const reply = replies_++;
+        auto const bytes = reply_bytes_ - left;
+        reply_bytes_ = left;
+
+        pending sample;
+        {
+            std::lock_guard<std::mutex> lock{mutex_};
+            while (!pending_.empty() && pending_.front().command < reply)
+                pending_.pop_front();
+            if (pending_.empty() || pending_.front().command != reply)
+                return;
+            sample = std::move(pending_.front());
+            pending_.pop_front();
+        }
+        monitor_->record(sample.key, sample.request_bytes, bytes);
+    }
+};
+
+// Wraps the stream so the commands sent through it are sampled into
+// the monitor, e.g. with execute, pipelines or auto_pipeline.
+[[nodiscard]]
+inline std::shared_ptr<std::iostream> monitor_stream(std::shared_ptr<std::iostream> stream,
+        std::shared_ptr<key_monitor> monitor)
+{
+    return std::make_shared<tapped_stream<key_sampler>>(std::move(stream), std::move(monitor));
+}
+
+}   // namespace rediscpp
+
+#endif  // !REDISCPP_KEY_MONITOR_H_
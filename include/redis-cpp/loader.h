@@ -0,0 +1,174 @@
+//-------------------------------------------------------------------
+//  redis-cpp
+//  https://github.com/tdv/redis-cpp
+//  Created:     10.2026
+//  Copyright 2020 Dmitry Tkachenko (tkachenkodmitryv@gmail.com)
+//  Distributed under the MIT License
+//  (See accompanying file LICENSE)
+//-------------------------------------------------------------------
+
+#ifndef REDISCPP_LOADER_H_
+#define REDISCPP_LOADER_H_
+
+// STD
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+#include <iterator>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <utility>
+
+// REDIS-CPP
+#include <redis-cpp/detail/config.h>
+#include <redis-cpp/error.h>
+#include <redis-cpp/execute.h>
+#include <redis-cpp/resp/decoding.h>
+#include <redis-cpp/resp/serialization.h>
+
+namespace rediscpp
+{
+
+struct load_stats final
+{
+    std::uint64_t succeeded = 0;
+    std::uint64_t failed = 0;
+    // The first error reply, the rest of them are only counted.
+    std::string first_error;
+};
+
+// Mass insertion like 'redis-cli --pipe'. The commands are written back
+// to back into the stream buffer (see stream_options::write_buffer_size)
+// and their replies are only counted. No more than 'window' commands are
+// sent without reading their replies, so the server's output buffer
+// for the client stays bounded.
+class loader final
+{
+public:
+    static constexpr std::size_t default_window = 10000;
+
+    explicit loader(std::iostream &stream, std::size_t window = default_window)
+        : stream_{stream}
+        , window_{std::max<std::size_t>(window, 1)}
+    {
+    }
+
+    loader(loader const &) = delete;
+    loader& operator = (loader const &) = delete;
+
+    template <typename ... TArgs>
+    void add(std::string_view name, TArgs && ... args)
+    {
+        execute_no_flush(stream_, std::move(name), std::forward<TArgs>(args) ... );
+        sent();
+    }
+
+    // The command is a range of arguments convertible into std::string_view,
+    // the first one is the name of the command.
+    template <typename TCommand>
+    void add_command(TCommand const &command)
+    {
+        put(stream_, resp::serialization::array_header{
+                static_cast<std::size_t>(std::distance(std::begin(command), std::end(command)))});
+        for (auto const &arg : command)
+            put(stream_, resp::serialization::bulk_string{std::string_view{arg}});
+        sent();
+    }
+
+    // The command is put by the function, e.g. with binary_data arguments.
+    template <typename TPut>
+    void add_with(TPut put_command)
+    {
+        put_command(static_cast<std::ostream &>(stream_));
+        sent();
+    }
+
+    // Sends the rest of the commands and waits for all the replies.
+    load_stats const& finish()
+    {
+        std::flush(stream_);
+        read_replies(0);
+        return stats_;
+    }
+
+    [[nodiscard]]
+    load_stats const& stats() const noexcept
+    {
+        return stats_;
+    }
+
+    // The number of commands sent without reading their replies.
+    [[nodiscard]]
+    std::size_t in_flight() const noexcept
+    {
+        return in_flight_;
+    }
+
+private:
+    std::iostream &stream_;
+    std::size_t const window_;
+    std::size_t in_flight_ = 0;
+    load_stats stats_;
+    resp::decoding::header header_;
+
+    void sent()
+    {
+        if (++in_flight_ < window_)
+            return;
+        std::flush(stream_);
+        // A half of the window is left, so the server has commands
+        // to execute while the replies are read.
+        read_replies(window_ / 2);
+    }
+
+    void read_replies(std::size_t keep)
+    {
+        while (in_flight_ > keep)
+        {
+            error err;
+            if (!header_.read(stream_, err) ||
+                    !resp::detail::decoding::skip(stream_, header_, err))
+            {
+                err.raise();
+            }
+            --in_flight_;
+
+            if (header_.mark() != resp::detail::marker::error_message)
+            {
+                ++stats_.succeeded;
+                continue;
+            }
+            if (!stats_.failed++)
+                stats_.first_error = header_.line();
+        }
+    }
+};
+
+// Sends the commands of [first, last), each one is a range of arguments.
+template <typename TIterator>
+load_stats load(std::iostream &stream, TIterator first, TIterator last,
+        std::size_t window = loader::default_window)
+{
+    loader bulk{stream, window};
+    for ( ; first != last ; ++first)
+        bulk.add_command(*first);
+    return bulk.finish();
+}
+
+// The generator returns std::optional of a command until
+// there are no more commands (std::nullopt).
+template <typename TGenerator>
+load_stats load(std::iostream &stream, TGenerator generator,
+        std::size_t window = loader::default_window)
+{
+    loader bulk{stream, window};
+    for (auto command = generator() ; command ; command = generator())
+        bulk.add_command(*command);
+    return bulk.finish();
+}
+
+}   // namespace rediscpp
+
+#endif  // !REDISCPP_LOADER_H_
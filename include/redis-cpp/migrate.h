@@ -0,0 +1,455 @@
+//-------------------------------------------------------------------
+//  redis-cpp
+//  https://github.com/tdv/redis-cpp
+//  Created:     10.2026
+//  Copyright 2020 Dmitry Tkachenko (tkachenkodmitryv@gmail.com)
+//  Distributed under the MIT License
+//  (See accompanying file LICENSE)
+//-------------------------------------------------------------------
+
+#ifndef REDISCPP_MIGRATE_H_
+#define REDISCPP_MIGRATE_H_
+
+// STD
+#include <algorithm>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <iostream>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <utility>
+#include <vector>
+
+// REDIS-CPP
+#include <redis-cpp/detail/config.h>
+#include <redis-cpp/error.h>
+#include <redis-cpp/execute.h>
+#include <redis-cpp/loader.h>
+#include <redis-cpp/resp/decoding.h>
+#include <redis-cpp/resp/serialization.h>
+
+namespace rediscpp
+{
+
+struct export_options final
+{
+    std::string match = "*";
+    // Keys per SCAN page, the DUMP and PTTL of a page are sent in one batch.
+    std::size_t count = 1000;
+};
+
+struct export_stats final
+{
+    std::uint64_t keys = 0;
+    // Removed or expired between SCAN and DUMP, or failed to be dumped.
+    std::uint64_t skipped = 0;
+    std::uint64_t bytes = 0;
+};
+
+// Scans the source and passes each key with its PTTL and DUMP payload to
+// sink(key, ttl, payload), the ttl is in milliseconds, 0 is for no expiry.
+// The DUMP and PTTL of a page and the SCAN of the next page are sent
+// in one write, so a page takes one round trip.
+// The export is sequential over one connection and the sink is called
+// by the caller's thread. Several exports with disjoint patterns can run
+// on their own connections and threads to read the source in parallel.
+template <typename TSink>
+[[nodiscard]]
+inline result<export_stats> export_keys(std::iostream &source, TSink &&sink,
+        export_options const &options = {})
+{
+    auto const count = std::to_string(options.count);
+    export_stats stats;
+    std::string payload;
+    std::int64_t ttl = 0;
+
+    execute_no_flush(source, "scan", "0", "match", options.match, "count", count);
+    std::flush(source);
+    for ( ; ; )
+    {
+        auto page = resp::decoding::try_decode<std::pair<std::string, std::vector<std::string>>>(source);
+        if (!page)
+            return page.error();
+        auto const &[cursor, keys] = *page;
+
+        for (auto const &key : keys)
+        {
+            execute_no_flush(source, "dump", key);
+            execute_no_flush(source, "pttl", key);
+        }
+        if (cursor != "0")
+            execute_no_flush(source, "scan", cursor, "match", options.match, "count", count);
+        std::flush(source);
+        if (!source)
+            return errc::io_error;
+
+        for (auto const &key : keys)
+        {
+            error err;
+            resp::decoding::header hdr;
+            auto const dumped = hdr.read(source, err) && resp::decoding::get(source, hdr, payload, err);
+            if (resp::detail::decoding::is_fatal(err))
+                return err;
+            err = {};
+            auto const expires = hdr.read(source, err) && resp::decoding::get(source, hdr, ttl, err);
+            if (resp::detail::decoding::is_fatal(err))
+                return err;
+
+            if (!dumped || !expires || ttl == -2)
+            {
+                ++stats.skipped;
+                continue;
+            }
+            sink(std::string_view{key}, ttl < 0 ? std::int64_t{0} : ttl, std::string_view{payload});
+            ++stats.keys;
+            stats.bytes += std::size(payload);
+        }
+
+        if (cursor == "0")
+            return stats;
+    }
+}
+
+// Writes the records into a file: the signature, then for each key
+// its length (u64), the key, the ttl (i64), the payload length (u64)
+// and the payload. The numbers are little-endian.
+class dump_writer final
+{
+public:
+    static constexpr std::string_view signature = "RCPPDMP2";
+    // The first version had u32 lengths, such dumps are still read.
+    static constexpr std::string_view signature_v1 = "RCPPDMP1";
+
+    explicit dump_writer(std::ostream &stream)
+        : stream_{stream}
+    {
+        stream_.write(std::data(signature), static_cast<std::streamsize>(std::size(signature)));
+    }
+
+    void operator () (std::string_view key, std::int64_t ttl, std::string_view payload)
+    {
+        put(static_cast<std::uint64_t>(std::size(key)), 8);
+        stream_.write(std::data(key), static_cast<std::streamsize>(std::size(key)));
+        put(static_cast<std::uint64_t>(ttl), 8);
+        put(static_cast<std::uint64_t>(std::size(payload)), 8);
+        stream_.write(std::data(payload), static_cast<std::streamsize>(std::size(payload)));
+    }
+
+private:
+    std::ostream &stream_;
+
+    void put(std::uint64_t number, std::size_t size)
+    {
+        char bytes[8];
+        for (std::size_t i = 0 ; i < size ; ++i)
+            bytes[i] = static_cast<char>((number >> (i * 8)) & 0xFF);
+        stream_.write(bytes, static_cast<std::streamsize>(size));
+    }
+};
+
+// Reads the records of dump_writer one by one, the views are valid
+// until the next record is read.
+class dump_reader final
+{
+public:
+    explicit dump_reader(std::istream &stream)
+        : stream_{stream}
+    {
+        char head[std::size(dump_writer::signature)];
+        stream_.read(head, static_cast<std::streamsize>(std::size(head)));
+        std::string_view const signature{head, std::size(head)};
+        if (stream_ && signature == dump_writer::signature_v1)
+            length_size_ = 4;
+        else if (!stream_ || signature != dump_writer::signature)
+            error_ = {make_error_code(errc::bad_format), "It's not a dump of rediscpp."};
+    }
+
+    // False at the end of the file or on an error.
+    [[nodiscard]]
+    bool next()
+    {
+        if (error_)
+            return false;
+        std::uint64_t size = 0;
+        std::uint64_t ttl = 0;
+        if (stream_.peek() == std::istream::traits_type::eof())
+            return false;
+        if (!get(size, length_size_) || !get(key_, size) || !get(ttl, 8) ||
+                !get(size, length_size_) || !get(payload_, size))
+        {
+            error_ = {make_error_code(errc::bad_format), "The dump is truncated."};
+            return false;
+        }
+        ttl_ = static_cast<std::int64_t>(ttl);
+        return true;
+    }
+
+    [[nodiscard]]
+    std::string_view key() const noexcept
+    {
+        return key_;
+    }
+
+    [[nodiscard]]
+    std::int64_t ttl() const noexcept
+    {
+        return ttl_;
+    }
+
+    [[nodiscard]]
+    std::string_view payload() const noexcept
+    {
+        return payload_;
+    }
+
+    [[nodiscard]]
+    rediscpp::error const& error() const noexcept
+    {
+        return error_;
+    }
+
+private:
+    std::istream &stream_;
+    std::string key_;
+    std::int64_t ttl_ = 0;
+    std::string payload_;
+    std::size_t length_size_ = 8;
+    rediscpp::error error_;
+
+    bool get(std::uint64_t &number, std::size_t size)
+    {
+        unsigned char bytes[8];
+        stream_.read(reinterpret_cast<char *>(bytes), static_cast<std::streamsize>(size));
+        if (!stream_)
+            return false;
+        number = 0;
+        for (std::size_t i = 0 ; i < size ; ++i)
+            number |= std::uint64_t{bytes[i]} << (i * 8);
+        return true;
+    }
+
+    bool get(std::string &data, std::uint64_t size)
+    {
+        data.resize(static_cast<std::size_t>(size));
+        if (size)
+            stream_.read(std::data(data), static_cast<std::streamsize>(size));
+        return static_cast<bool>(stream_);
+    }
+};
+
+// A sink of export_keys which sends RESTORE to the targets, e.g. several
+// connections to one server. Each target has at most `window` commands
+// waiting for their replies (see loader). With several targets each one
+// is written by its own thread, so a target which waits for its replies
+// doesn't hold up the others: the records are queued (no more than
+// `queue_size` of them) and taken by the first free thread.
+// A single target is written by the caller's thread with no queue.
+// The payloads are sent as they are, with no conversions.
+class restorer final
+{
+public:
+    static constexpr std::size_t default_queue_size = 1024;
+
+    explicit restorer(std::vector<std::iostream *> const &targets,
+            std::size_t window = loader::default_window, bool replace = true,
+            std::size_t queue_size = default_queue_size)
+        : replace_{replace}
+        , queue_size_{std::max<std::size_t>(queue_size, 1)}
+    {
+        if (targets.empty())
+            throw std::invalid_argument{"[rediscpp::restorer] There are no targets."};
+
+        for (auto *target : targets)
+            loaders_.emplace_back(*target, window);
+        if (std::size(loaders_) < 2)
+            return;
+
+        try
+        {
+            active_ = std::size(loaders_);
+            workers_.reserve(std::size(loaders_));
+            for (auto &target : loaders_)
+                workers_.emplace_back([this, &target] { work(target); });
+        }
+        catch (...)
+        {
+            stop();
+            throw;
+        }
+    }
+
+    explicit restorer(std::iostream &target, std::size_t window = loader::default_window,
+            bool replace = true)
+        : restorer{std::vector<std::iostream *>{&target}, window, replace}
+    {
+    }
+
+    restorer(restorer const &) = delete;
+    restorer& operator = (restorer const &) = delete;
+
+    // The rest of the queued records are dropped if finish isn't called.
+    ~restorer() noexcept
+    {
+        stop();
+    }
+
+    void operator () (std::string_view key, std::int64_t ttl, std::string_view payload)
+    {
+        if (workers_.empty())
+        {
+            restore(loaders_.front(), key, ttl, payload);
+            return;
+        }
+
+        {
+            std::unique_lock<std::mutex> lock{mutex_};
+            not_full_.wait(lock, [this] { return std::size(queue_) < queue_size_ || !active_; });
+            // All the targets have failed.
+            if (!active_)
+                std::rethrow_exception(error_);
+            queue_.push_back({std::string{key}, ttl, std::string{payload}});
+        }
+        not_empty_.notify_one();
+    }
+
+    // Waits for the rest of the replies on all the targets.
+    load_stats finish()
+    {
+        if (!workers_.empty())
+        {
+            {
+                std::lock_guard<std::mutex> lock{mutex_};
+                finishing_ = true;
+            }
+            not_empty_.notify_all();
+            for (auto &worker : workers_)
+                worker.join();
+            workers_.clear();
+            if (error_)
+                std::rethrow_exception(error_);
+        }
+
+        load_stats res;
+        for (auto &target : loaders_)
+        {
+            auto const &stats = target.finish();
+            res.succeeded += stats.succeeded;
+            res.failed += stats.failed;
+            if (res.first_error.empty())
+                res.first_error = stats.first_error;
+        }
+        return res;
+    }
+
+private:
+    struct record final
+    {
+        std::string key;
+        std::int64_t ttl;
+        std::string payload;
+    };
+
+    bool const replace_;
+    std::size_t const queue_size_;
+    std::deque<loader> loaders_;
+
+    std::mutex mutex_;
+    std::condition_variable not_empty_;
+    std::condition_variable not_full_;
+    std::deque<record> queue_;
+    bool finishing_ = false;
+    bool stopped_ = false;
+    std::size_t active_ = 0;
+    // The first error of the threads.
+    std::exception_ptr error_;
+    std::vector<std::thread> workers_;
+
+    void restore(loader &target, std::string_view key, std::int64_t ttl, std::string_view payload)
+    {
+        auto const expiry = std::to_string(ttl);
+        target.add_with(
+                [&] (std::ostream &stream)
+                {
+                    put(stream, resp::serialization::array_header{replace_ ? 5u : 4u});
+                    put(stream, resp::serialization::bulk_string{"restore"});
+                    put(stream, resp::serialization::binary_data{std::data(key), std::size(key)});
+                    put(stream, resp::serialization::bulk_string{expiry});
+                    put(stream, resp::serialization::binary_data{std::data(payload), std::size(payload)});
+                    if (replace_)
+                        put(stream, resp::serialization::bulk_string{"replace"});
+                }
+            );
+    }
+
+    // A failed target stops taking the records, the others go on.
+    void work(loader &target)
+    {
+        try
+        {
+            for (;;)
+            {
+                std::unique_lock<std::mutex> lock{mutex_};
+                not_empty_.wait(lock, [this] { return !queue_.empty() || finishing_ || stopped_; });
+                if (stopped_)
+                    return;
+                if (queue_.empty())
+                    break;
+                auto item = std::move(queue_.front());
+                queue_.pop_front();
+                lock.unlock();
+                not_full_.notify_one();
+
+                restore(target, item.key, item.ttl, item.payload);
+            }
+            target.finish();
+        }
+        catch (...)
+        {
+            {
+                std::lock_guard<std::mutex> lock{mutex_};
+                if (!error_)
+                    error_ = std::current_exception();
+                --active_;
+            }
+            not_full_.notify_all();
+        }
+    }
+
+    void stop() noexcept
+    {
+        {
+            std::lock_guard<std::mutex> lock{mutex_};
+            stopped_ = true;
+        }
+        not_empty_.notify_all();
+        for (auto &worker : workers_)
+        {
+            if (worker.joinable())
+                worker.join();
+        }
+        workers_.clear();
+    }
+};
+
+// Restores the keys of a dump file.
+[[nodiscard]]
+inline result<load_stats> import_keys(std::istream &file, restorer &target)
+{
+    dump_reader reader{file};
+    while (reader.next())
+        target(reader.key(), reader.ttl(), reader.payload());
+    auto stats = target.finish();
+    if (reader.error())
+        return reader.error();
+    return stats;
+}
+
+}   // namespace rediscpp
+
+#endif  // !REDISCPP_MIGRATE_H_
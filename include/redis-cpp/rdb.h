@@ -0,0 +1,1036 @@
+//-------------------------------------------------------------------
+//  redis-cpp
+//  https://github.com/tdv/redis-cpp
+//  Created:     10.2026
+//  Copyright 2020 Dmitry Tkachenko (tkachenkodmitryv@gmail.com)
+//  Distributed under the MIT License
+//  (See accompanying file LICENSE)
+//-------------------------------------------------------------------
+
+#ifndef REDISCPP_RDB_H_
+#define REDISCPP_RDB_H_
+
+#ifndef REDISCPP_PURE_CORE
+
+// STD
+#include <algorithm>
+#include <charconv>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <istream>
+#include <streambuf>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+// BOOST
+#include <boost/iostreams/device/mapped_file.hpp>
+
+// REDIS-CPP
+#include <redis-cpp/detail/config.h>
+#include <redis-cpp/error.h>
+#include <redis-cpp/resp/decoding.h>
+#include <redis-cpp/value.h>
+
+namespace rediscpp
+{
+
+enum class rdb_type
+{
+    string,
+    list,
+    set,
+    sorted_set,
+    hash,
+    stream,
+    module
+};
+
+// The start of a key with the database it belongs to.
+struct rdb_position final
+{
+    std::size_t offset = 0;
+    std::int64_t db = 0;
+};
+
+// A memory mapped file, e.g. dump.rdb. It throws std::ios_base::failure
+// if the file can't be mapped.
+class rdb_file final
+{
+public:
+    explicit rdb_file(std::string const &path)
+        : file_{path}
+    {
+    }
+
+    [[nodiscard]]
+    std::string_view data() const noexcept
+    {
+        return {file_.data(), file_.size()};
+    }
+
+private:
+    boost::iostreams::mapped_file_source file_;
+};
+
+// Reads the keys of an RDB snapshot one by one. A value isn't decoded until
+// it's asked for: for_each passes its items as they're stored, the ziplist,
+// listpack, intset and zipmap encodings and LZF compressed strings included.
+// try_get and try_as give the same reply as the commands would, e.g. a flat
+// array of fields and values for a hash (HGETALL) or of members and scores
+// for a sorted set (ZRANGE WITHSCORES). The values of streams and modules
+// are skipped, so are the TTLs of the hash fields (Redis 7.4 or higher).
+// The views are valid until the next key is read.
+// The readers of the ranges made by split can be used by several threads.
+class rdb_reader final
+{
+public:
+    explicit rdb_reader(std::string_view data)
+        : data_{data}
+        , end_{std::size(data)}
+    {
+        auto const head = data_.substr(0, 9);
+        auto const digits = std::size(head) == 9 && std::all_of(std::begin(head) + 5, std::end(head),
+                [] (char c) { return c >= '0' && c <= '9'; });
+        if (!digits || head.substr(0, 5) != "REDIS")
+        {
+            error_ = {make_error_code(errc::bad_format), "It's not an RDB file."};
+            return;
+        }
+        version_ = std::stoi(std::string{head.substr(5)});
+        at_.pos = std::size(head);
+    }
+
+    // Reads the keys of [begin, end), see split.
+    rdb_reader(std::string_view data, rdb_position const &begin, rdb_position const &end)
+        : rdb_reader{data}
+    {
+        if (error_)
+            return;
+        at_.pos = std::max(at_.pos, begin.offset);
+        db_ = begin.db;
+        end_ = std::min(end.offset, std::size(data_));
+    }
+
+    // Splits the keys into the ranges of about the same size. The positions
+    // are the starts of the ranges and the end of the last one.
+    [[nodiscard]]
+    static result<std::vector<rdb_position>> split(std::string_view data, std::size_t parts)
+    {
+        rdb_reader reader{data};
+        if (reader.error_)
+            return reader.error_;
+
+        parts = std::max<std::size_t>(parts, 1);
+        auto const step = std::size(data) / parts;
+        std::vector<rdb_position> res{{reader.at_.pos, 0}};
+        while (reader.next())
+        {
+            if (std::size(res) < parts && reader.entry_.offset >= std::size(res) * step)
+                res.push_back(reader.entry_);
+        }
+        if (reader.error_)
+            return reader.error_;
+        res.push_back({std::size(data), reader.db_});
+        return res;
+    }
+
+    // False at the end or on an error.
+    [[nodiscard]]
+    bool next()
+    {
+        if (error_ || done_)
+            return false;
+        try
+        {
+            if (pending_)
+            {
+                at_.pos = value_at_;
+                skip_value(at_, encoding_);
+                pending_ = false;
+            }
+            return read_key();
+        }
+        catch (truncated const &)
+        {
+            fail("The file is truncated.");
+        }
+        catch (unsupported const &)
+        {
+            fail("The file has an unsupported value type or encoding.");
+        }
+        return false;
+    }
+
+    [[nodiscard]]
+    int version() const noexcept
+    {
+        return version_;
+    }
+
+    [[nodiscard]]
+    std::int64_t db() const noexcept
+    {
+        return db_;
+    }
+
+    [[nodiscard]]
+    std::string_view key() const noexcept
+    {
+        return key_;
+    }
+
+    // Unix time in milliseconds, -1 if the key doesn't expire.
+    [[nodiscard]]
+    std::int64_t expiry() const noexcept
+    {
+        return expiry_;
+    }
+
+    [[nodiscard]]
+    rdb_type type() const noexcept
+    {
+        switch (encoding_)
+        {
+        case 0 :
+            return rdb_type::string;
+        case 1 :
+        case 10 :
+        case 14 :
+        case 18 :
+            return rdb_type::list;
+        case 2 :
+        case 11 :
+        case 20 :
+            return rdb_type::set;
+        case 3 :
+        case 5 :
+        case 12 :
+        case 17 :
+            return rdb_type::sorted_set;
+        case 4 :
+        case 9 :
+        case 13 :
+        case 16 :
+        case 22 :
+        case 23 :
+        case 24 :
+        case 25 :
+            return rdb_type::hash;
+        case 15 :
+        case 19 :
+        case 21 :
+            return rdb_type::stream;
+        default :
+            break;
+        }
+        return rdb_type::module;
+    }
+
+    // The type of the value as it's stored, e.g. 16 for a hash in a listpack.
+    [[nodiscard]]
+    std::uint8_t encoding() const noexcept
+    {
+        return encoding_;
+    }
+
+    // Calls func(std::string_view) for each item of the value, the numbers
+    // are formatted as the server does. False for a stream or a module.
+    template <typename TFunc>
+    [[nodiscard]]
+    bool for_each(TFunc func)
+    {
+        if (!pending_ || type() == rdb_type::stream || type() == rdb_type::module)
+            return false;
+        try
+        {
+            cursor at{data_, value_at_};
+            items(at, func);
+            return true;
+        }
+        catch (truncated const &)
+        {
+            fail("The file is truncated.");
+        }
+        catch (unsupported const &)
+        {
+            fail("The file has an unsupported value type or encoding.");
+        }
+        return false;
+    }
+
+    [[nodiscard]]
+    result<value> try_get()
+    {
+        if (!to_resp())
+            return error_ ? error_ : rediscpp::error{make_error_code(errc::type_mismatch)};
+        view_streambuf buf{resp_};
+        std::istream stream{&buf};
+        return value{stream};
+    }
+
+    template <typename T>
+    [[nodiscard]]
+    result<T> try_as()
+    {
+        if (!to_resp())
+            return error_ ? error_ : rediscpp::error{make_error_code(errc::type_mismatch)};
+        view_streambuf buf{resp_};
+        std::istream stream{&buf};
+        return resp::decoding::try_decode<T>(stream);
+    }
+
+    template <typename T>
+    [[nodiscard]]
+    T as()
+    {
+        return try_as<T>().value();
+    }
+
+    [[nodiscard]]
+    rediscpp::error const& error() const noexcept
+    {
+        return error_;
+    }
+
+private:
+    struct truncated final
+    {
+    };
+
+    struct unsupported final
+    {
+    };
+
+    class view_streambuf final
+        : public std::streambuf
+    {
+    public:
+        explicit view_streambuf(std::string &data) noexcept
+        {
+            auto *begin = std::data(data);
+            setg(begin, begin, begin + std::size(data));
+        }
+    };
+
+    struct cursor final
+    {
+        std::string_view data;
+        std::size_t pos = 0;
+
+        std::uint8_t byte()
+        {
+            if (pos >= std::size(data))
+                throw truncated{};
+            return static_cast<std::uint8_t>(data[pos++]);
+        }
+
+        std::string_view take(std::uint64_t size)
+        {
+            if (size > std::size(data) - pos)
+                throw truncated{};
+            auto const res = data.substr(pos, static_cast<std::size_t>(size));
+            pos += static_cast<std::size_t>(size);
+            return res;
+        }
+
+        // Little-endian, as the fixed size numbers of RDB are.
+        std::uint64_t number(std::size_t size)
+        {
+            auto const bytes = take(size);
+            std::uint64_t res = 0;
+            for (std::size_t i = 0 ; i < size ; ++i)
+                res |= std::uint64_t{static_cast<std::uint8_t>(bytes[i])} << (i * 8);
+            return res;
+        }
+
+        // A length or, if special is set, the kind of an encoded string.
+        std::uint64_t length(bool *special = nullptr)
+        {
+            auto const first = byte();
+            if (special)
+                *special = false;
+            switch (first >> 6)
+            {
+            case 0 :
+                return first & 0x3F;
+            case 1 :
+                return (std::uint64_t{first & 0x3Fu} << 8) | byte();
+            case 2 :
+                {
+                    std::size_t size = 0;
+                    if (first == 0x80)
+                        size = 4;
+                    else if (first == 0x81)
+                        size = 8;
+                    else
+                        throw unsupported{};
+                    std::uint64_t res = 0;
+                    for (auto const c : take(size))
+                        res = (res << 8) | static_cast<std::uint8_t>(c);
+                    return res;
+                }
+            default :
+                break;
+            }
+            if (!special)
+                throw unsupported{};
+            *special = true;
+            return first & 0x3F;
+        }
+
+        // The view is of the data or of the buffer if the string is encoded.
+        std::string_view string(std::string &buffer)
+        {
+            bool special = false;
+            auto const size = length(&special);
+            if (!special)
+                return take(size);
+            switch (size)
+            {
+            case 0 :
+                return format(static_cast<std::int8_t>(number(1)), buffer);
+            case 1 :
+                return format(static_cast<std::int16_t>(number(2)), buffer);
+            case 2 :
+                return format(static_cast<std::int32_t>(number(4)), buffer);
+            case 3 :
+                {
+                    auto const compressed = length();
+                    auto const original = length();
+                    lzf(take(compressed), original, buffer);
+                    return buffer;
+                }
+            default :
+                break;
+            }
+            throw unsupported{};
+        }
+
+        void skip_string()
+        {
+            bool special = false;
+            auto const size = length(&special);
+            if (!special)
+            {
+                take(size);
+                return;
+            }
+            switch (size)
+            {
+            case 0 :
+                take(1);
+                return;
+            case 1 :
+                take(2);
+                return;
+            case 2 :
+                take(4);
+                return;
+            case 3 :
+                {
+                    auto const compressed = length();
+                    length();
+                    take(compressed);
+                    return;
+                }
+            default :
+                break;
+            }
+            throw unsupported{};
+        }
+    };
+
+    std::string_view data_;
+    std::size_t end_ = 0;
+    int version_ = 0;
+    cursor at_{data_, 0};
+    rdb_position entry_;
+    bool done_ = false;
+    bool pending_ = false;
+    std::size_t value_at_ = 0;
+
+    std::int64_t db_ = 0;
+    std::string_view key_;
+    std::int64_t expiry_ = -1;
+    std::uint8_t encoding_ = 0;
+    rediscpp::error error_;
+
+    std::string key_buffer_;
+    std::string blob_buffer_;
+    std::string item_buffer_;
+    std::string resp_;
+
+    void fail(char const *message)
+    {
+        error_ = {make_error_code(errc::bad_format), message};
+        done_ = true;
+        pending_ = false;
+    }
+
+    bool read_key()
+    {
+        expiry_ = -1;
+        entry_ = {at_.pos, db_};
+        for ( ; ; )
+        {
+            if (at_.pos >= end_)
+            {
+                done_ = true;
+                return false;
+            }
+
+            auto const opcode = at_.byte();
+            switch (opcode)
+            {
+            case 0xFF :     // EOF, the checksum follows
+                done_ = true;
+                return false;
+            case 0xFE :     // SELECTDB
+                db_ = static_cast<std::int64_t>(at_.length());
+                break;
+            case 0xFD :     // EXPIRETIME in seconds
+                expiry_ = static_cast<std::int64_t>(at_.number(4)) * 1000;
+                break;
+            case 0xFC :     // EXPIRETIME_MS
+                expiry_ = static_cast<std::int64_t>(at_.number(8));
+                break;
+            case 0xFB :     // RESIZEDB
+                at_.length();
+                at_.length();
+                break;
+            case 0xFA :     // AUX
+                at_.skip_string();
+                at_.skip_string();
+                break;
+            case 0xF9 :     // FREQ
+                at_.byte();
+                break;
+            case 0xF8 :     // IDLE
+                at_.length();
+                break;
+            case 0xF7 :     // MODULE_AUX
+                at_.length();
+                at_.length();
+                at_.length();
+                skip_module(at_);
+                break;
+            case 0xF5 :     // FUNCTION2
+                at_.skip_string();
+                break;
+            case 0xF4 :     // SLOT_INFO
+                at_.length();
+                at_.length();
+                at_.length();
+                break;
+            default :
+                if (opcode > 25)
+                    throw unsupported{};
+                encoding_ = opcode;
+                key_ = at_.string(key_buffer_);
+                value_at_ = at_.pos;
+                pending_ = true;
+                return true;
+            }
+        }
+    }
+
+    static void skip_module(cursor &at)
+    {
+        for (auto opcode = at.length() ; opcode != 0 ; opcode = at.length())
+        {
+            switch (opcode)
+            {
+            case 1 :    // SINT
+            case 2 :    // UINT
+                at.length();
+                break;
+            case 3 :    // FLOAT
+                at.take(4);
+                break;
+            case 4 :    // DOUBLE
+                at.take(8);
+                break;
+            case 5 :    // STRING
+                at.skip_string();
+                break;
+            default :
+                throw unsupported{};
+            }
+        }
+    }
+
+    static void skip_value(cursor &at, std::uint8_t encoding)
+    {
+        switch (encoding)
+        {
+        case 0 :
+        case 9 :
+        case 10 :
+        case 11 :
+        case 12 :
+        case 13 :
+        case 16 :
+        case 17 :
+        case 20 :
+            at.skip_string();
+            return;
+        case 1 :
+        case 2 :
+        case 14 :
+            for (auto count = at.length() ; count ; --count)
+                at.skip_string();
+            return;
+        case 3 :
+            for (auto count = at.length() ; count ; --count)
+            {
+                at.skip_string();
+                auto const size = at.byte();
+                if (size < 253)
+                    at.take(size);
+            }
+            return;
+        case 4 :
+            for (auto count = at.length() ; count ; --count)
+            {
+                at.skip_string();
+                at.skip_string();
+            }
+            return;
+        case 5 :
+            for (auto count = at.length() ; count ; --count)
+            {
+                at.skip_string();
+                at.take(8);
+            }
+            return;
+        case 7 :
+            at.length();
+            skip_module(at);
+            return;
+        case 15 :
+        case 19 :
+        case 21 :
+            skip_stream(at, encoding);
+            return;
+        case 18 :
+            for (auto count = at.length() ; count ; --count)
+            {
+                at.length();
+                at.skip_string();
+            }
+            return;
+        case 22 :
+        case 24 :
+            if (encoding == 24)
+                at.take(8);     // The minimal expire time of the fields
+            for (auto count = at.length() ; count ; --count)
+            {
+                at.length();    // The TTL of the field
+                at.skip_string();
+                at.skip_string();
+            }
+            return;
+        case 23 :
+        case 25 :
+            if (encoding == 25)
+                at.take(8);
+            at.skip_string();
+            return;
+        default :
+            break;
+        }
+        throw unsupported{};
+    }
+
+    static void skip_stream(cursor &at, std::uint8_t encoding)
+    {
+        for (auto count = at.length() ; count ; --count)
+        {
+            at.skip_string();   // The master ID
+            at.skip_string();   // The listpack
+        }
+        at.length();            // The number of entries
+        at.length();            // The last ID
+        at.length();
+        if (encoding >= 19)
+        {
+            for (auto i = 0 ; i < 5 ; ++i)  // The first and max deleted IDs, entries added
+                at.length();
+        }
+        for (auto groups = at.length() ; groups ; --groups)
+        {
+            at.skip_string();
+            at.length();
+            at.length();
+            if (encoding >= 19)
+                at.length();    // Entries read
+            for (auto pending = at.length() ; pending ; --pending)
+            {
+                at.take(16 + 8);
+                at.length();
+            }
+            for (auto consumers = at.length() ; consumers ; --consumers)
+            {
+                at.skip_string();
+                at.take(encoding >= 21 ? 16 : 8);
+                at.take(at.length() * 16);
+            }
+        }
+    }
+
+    template <typename TFunc>
+    void items(cursor &at, TFunc &func)
+    {
+        switch (encoding_)
+        {
+        case 0 :
+            func(at.string(item_buffer_));
+            return;
+        case 1 :
+        case 2 :
+            for (auto count = at.length() ; count ; --count)
+                func(at.string(item_buffer_));
+            return;
+        case 3 :
+            for (auto count = at.length() ; count ; --count)
+            {
+                func(at.string(item_buffer_));
+                auto const size = at.byte();
+                if (size == 253)
+                    func(std::string_view{"nan"});
+                else if (size == 254)
+                    func(std::string_view{"inf"});
+                else if (size == 255)
+                    func(std::string_view{"-inf"});
+                else
+                    func(at.take(size));
+            }
+            return;
+        case 4 :
+            for (auto count = at.length() * 2 ; count ; --count)
+                func(at.string(item_buffer_));
+            return;
+        case 5 :
+            for (auto count = at.length() ; count ; --count)
+            {
+                func(at.string(item_buffer_));
+                double score = 0;
+                auto const bits = at.number(8);
+                std::memcpy(&score, &bits, sizeof(score));
+                func(format_score(score, item_buffer_));
+            }
+            return;
+        case 9 :
+            zipmap(at.string(blob_buffer_), func);
+            return;
+        case 10 :
+        case 12 :
+        case 13 :
+            ziplist(at.string(blob_buffer_), func);
+            return;
+        case 11 :
+            intset(at.string(blob_buffer_), func);
+            return;
+        case 14 :
+            for (auto count = at.length() ; count ; --count)
+                ziplist(at.string(blob_buffer_), func);
+            return;
+        case 16 :
+        case 17 :
+        case 20 :
+            listpack(at.string(blob_buffer_), func);
+            return;
+        case 18 :
+            for (auto count = at.length() ; count ; --count)
+            {
+                auto const container = at.length();
+                auto const blob = at.string(blob_buffer_);
+                if (container == 1)     // PLAIN, a large item on its own
+                    func(blob);
+                else
+                    listpack(blob, func);
+            }
+            return;
+        case 22 :
+        case 24 :
+            if (encoding_ == 24)
+                at.take(8);
+            for (auto count = at.length() ; count ; --count)
+            {
+                at.length();
+                func(at.string(item_buffer_));
+                func(at.string(item_buffer_));
+            }
+            return;
+        case 23 :
+        case 25 :
+            {
+                if (encoding_ == 25)
+                    at.take(8);
+                // The items are the field, the value and the TTL of the field.
+                std::size_t index = 0;
+                auto const pairs = [&func, &index] (std::string_view item)
+                    {
+                        if (index++ % 3 != 2)
+                            func(item);
+                    };
+                listpack(at.string(blob_buffer_), pairs);
+            }
+            return;
+        default :
+            break;
+        }
+        throw unsupported{};
+    }
+
+    template <typename TFunc>
+    void ziplist(std::string_view blob, TFunc &func)
+    {
+        cursor at{blob, 10};
+        for ( ; ; )
+        {
+            auto const prev = at.byte();
+            if (prev == 0xFF)
+                return;
+            if (prev == 0xFE)
+                at.take(4);
+
+            auto const enc = at.byte();
+            switch (enc >> 6)
+            {
+            case 0 :
+                func(at.take(enc & 0x3F));
+                continue;
+            case 1 :
+                func(at.take((std::uint64_t{enc & 0x3Fu} << 8) | at.byte()));
+                continue;
+            case 2 :
+                {
+                    std::uint64_t size = 0;
+                    for (auto const c : at.take(4))
+                        size = (size << 8) | static_cast<std::uint8_t>(c);
+                    func(at.take(size));
+                    continue;
+                }
+            default :
+                break;
+            }
+
+            std::int64_t number = 0;
+            switch (enc)
+            {
+            case 0xC0 :
+                number = static_cast<std::int16_t>(at.number(2));
+                break;
+            case 0xD0 :
+                number = static_cast<std::int32_t>(at.number(4));
+                break;
+            case 0xE0 :
+                number = static_cast<std::int64_t>(at.number(8));
+                break;
+            case 0xF0 :
+                number = sign(at.number(3), 24);
+                break;
+            case 0xFE :
+                number = static_cast<std::int8_t>(at.number(1));
+                break;
+            default :
+                if (enc < 0xF1 || enc > 0xFD)
+                    throw unsupported{};
+                number = (enc & 0x0F) - 1;
+                break;
+            }
+            func(format(number, item_buffer_));
+        }
+    }
+
+    template <typename TFunc>
+    void listpack(std::string_view blob, TFunc &func)
+    {
+        cursor at{blob, 6};
+        for ( ; ; )
+        {
+            auto const start = at.pos;
+            auto const enc = at.byte();
+            if (enc == 0xFF)
+                return;
+
+            if ((enc & 0x80) == 0)
+            {
+                func(format(std::int64_t{enc & 0x7F}, item_buffer_));
+            }
+            else if ((enc & 0xC0) == 0x80)
+            {
+                func(at.take(enc & 0x3F));
+            }
+            else if ((enc & 0xE0) == 0xC0)
+            {
+                func(format(sign((std::uint64_t{enc & 0x1Fu} << 8) | at.byte(), 13), item_buffer_));
+            }
+            else if ((enc & 0xF0) == 0xE0)
+            {
+                func(at.take((std::uint64_t{enc & 0x0Fu} << 8) | at.byte()));
+            }
+            else
+            {
+                switch (enc)
+                {
+                case 0xF0 :
+                    func(at.take(at.number(4)));
+                    break;
+                case 0xF1 :
+                    func(format(static_cast<std::int16_t>(at.number(2)), item_buffer_));
+                    break;
+                case 0xF2 :
+                    func(format(sign(at.number(3), 24), item_buffer_));
+                    break;
+                case 0xF3 :
+                    func(format(static_cast<std::int32_t>(at.number(4)), item_buffer_));
+                    break;
+                case 0xF4 :
+                    func(format(static_cast<std::int64_t>(at.number(8)), item_buffer_));
+                    break;
+                default :
+                    throw unsupported{};
+                }
+            }
+
+            // The length of the entry backwards, to walk from the tail.
+            auto const size = at.pos - start;
+            at.take(size < 128 ? 1 : size < 16383 ? 2 : size < 2097151 ? 3 : size < 268435455 ? 4 : 5);
+        }
+    }
+
+    template <typename TFunc>
+    void intset(std::string_view blob, TFunc &func)
+    {
+        cursor at{blob, 0};
+        auto const size = static_cast<std::size_t>(at.number(4));
+        if (size != 2 && size != 4 && size != 8)
+            throw unsupported{};
+        for (auto count = at.number(4) ; count ; --count)
+            func(format(sign(at.number(size), size * 8), item_buffer_));
+    }
+
+    template <typename TFunc>
+    void zipmap(std::string_view blob, TFunc &func)
+    {
+        cursor at{blob, 1};
+        auto const length = [&at] () -> std::uint64_t
+            {
+                auto const size = at.byte();
+                if (size < 254)
+                    return size;
+                if (size == 254)
+                    return at.number(4);
+                return 255;
+            };
+
+        for (auto size = length() ; size != 255 ; size = length())
+        {
+            func(at.take(size));
+            auto const value_size = length();
+            if (value_size == 255)
+                throw unsupported{};
+            auto const free = at.byte();
+            func(at.take(value_size));
+            at.take(free);
+        }
+    }
+
+    // The value as the reply to a command, it's decoded by the RESP decoders.
+    bool to_resp()
+    {
+        if (!pending_)
+            return false;
+        resp_.clear();
+        std::size_t count = 0;
+        std::string body;
+        auto const append = [this, &count, &body] (std::string_view item)
+            {
+                body.push_back('$');
+                body.append(std::to_string(std::size(item)));
+                body.append("\r\n");
+                body.append(item);
+                body.append("\r\n");
+                ++count;
+            };
+        if (!for_each(append))
+            return false;
+        if (type() != rdb_type::string)
+        {
+            resp_.push_back('*');
+            resp_.append(std::to_string(count));
+            resp_.append("\r\n");
+        }
+        resp_.append(body);
+        return true;
+    }
+
+    static std::int64_t sign(std::uint64_t number, std::size_t bits) noexcept
+    {
+        if (bits >= 64)
+            return static_cast<std::int64_t>(number);
+        auto const top = std::uint64_t{1} << (bits - 1);
+        return static_cast<std::int64_t>(number ^ top) - static_cast<std::int64_t>(top);
+    }
+
+    static std::string_view format(std::int64_t number, std::string &buffer)
+    {
+        buffer.resize(24);
+        auto const res = std::to_chars(std::data(buffer), std::data(buffer) + std::size(buffer), number);
+        buffer.resize(static_cast<std::size_t>(res.ptr - std::data(buffer)));
+        return buffer;
+    }
+
+    static std::string_view format_score(double number, std::string &buffer)
+    {
+        if (std::isinf(number))
+            return number > 0 ? "inf" : "-inf";
+        buffer.resize(32);
+        auto const size = std::snprintf(std::data(buffer), std::size(buffer), "%.17g", number);
+        buffer.resize(static_cast<std::size_t>(std::max(size, 0)));
+        return buffer;
+    }
+
+    static void lzf(std::string_view in, std::uint64_t size, std::string &out)
+    {
+        // A reference of 3 bytes gives 264 bytes at most.
+        if (size > std::uint64_t{std::size(in)} * 88)
+            throw unsupported{};
+        out.clear();
+        out.reserve(static_cast<std::size_t>(size));
+        cursor at{in, 0};
+        while (at.pos < std::size(in))
+        {
+            std::size_t const ctrl = at.byte();
+            if (ctrl < 32)
+            {
+                out.append(at.take(ctrl + 1));
+                continue;
+            }
+            auto length = ctrl >> 5;
+            if (length == 7)
+                length += at.byte();
+            auto const back = ((ctrl & 0x1F) << 8) + at.byte() + 1;
+            if (back > std::size(out))
+                throw unsupported{};
+            auto from = std::size(out) - back;
+            for (std::size_t i = 0 ; i < length + 2 ; ++i)
+                out.push_back(out[from++]);
+        }
+        if (std::size(out) != size)
+            throw unsupported{};
+    }
+};
+
+}   // namespace rediscpp
+
+#endif  // !REDISCPP_PURE_CORE
+
+#endif  // !REDISCPP_RDB_H_
@@ -0,0 +1,404 @@
+//-------------------------------------------------------------------
+//  redis-cpp
+//  https://github.com/tdv/redis-cpp
+//  Created:     10.2026
+//  Copyright 2020 Dmitry Tkachenko (tkachenkodmitryv@gmail.com)
+//  Distributed under the MIT License
+//  (See accompanying file LICENSE)
+//-------------------------------------------------------------------
+
+#ifndef REDISCPP_REPLICATION_H_
+#define REDISCPP_REPLICATION_H_
+
+#ifndef REDISCPP_PURE_CORE
+
+// STD
+#include <algorithm>
+#include <atomic>
+#include <cctype>
+#include <charconv>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <utility>
+#include <vector>
+
+// REDIS-CPP
+#include <redis-cpp/detail/config.h>
+// The header-only transport goes before the RESP headers.
+#include <redis-cpp/stream.h>
+#include <redis-cpp/error.h>
+#include <redis-cpp/execute.h>
+#include <redis-cpp/resp/decoding.h>
+
+namespace rediscpp
+{
+
+struct replication_options final
+{
+    stream_options connection;
+    // The position to go on from, e.g. replid() and offset() of a previous
+    // run. "?" and -1 ask for a full resynchronization.
+    std::string replid = "?";
+    std::int64_t offset = -1;
+    // REPLCONF ACK is sent at least so often, the primary also asks for it
+    // with REPLCONF GETACK.
+    std::chrono::milliseconds ack_interval{1000};
+    // Announced with REPLCONF listening-port, zero isn't announced.
+    std::uint16_t listening_port = 0;
+};
+
+// Connects to a primary as a replica (REPLCONF and PSYNC) and gets all the
+// writes in the order they're applied, unlike keyspace notifications
+// nothing is lost while the link is up and the server doesn't format events.
+// The snapshot of a full resynchronization is passed on in pieces as it's
+// read, both as a bulk with the length and as a diskless transfer with
+// an EOF mark, then the commands are parsed one by one. The offset counts
+// the bytes of the commands, PING and REPLCONF included, and is acknowledged
+// with REPLCONF ACK. After a break run() goes on from replid() and offset()
+// with PSYNC, the primary sends the missed commands if its backlog has them.
+class replication_consumer final
+{
+public:
+    replication_consumer(std::string host, std::string port, replication_options options = {})
+        : host_{std::move(host)}
+        , port_{std::move(port)}
+        , options_{std::move(options)}
+        , replid_{options_.replid}
+        , offset_{options_.offset}
+    {
+    }
+
+    replication_consumer(replication_consumer const &) = delete;
+    replication_consumer& operator = (replication_consumer const &) = delete;
+
+    // on_snapshot(chunk) gets the RDB of a full resynchronization, e.g. to be
+    // written into a file for rdb_reader, an empty chunk ends it.
+    // on_command(args, offset) gets each command with the offset after it,
+    // the views are valid until it returns. SELECT, MULTI and EXEC are
+    // passed on, PING and REPLCONF aren't.
+    // Runs until stop() or an error, the error is returned.
+    template <typename TSnapshot, typename TCommand>
+    [[nodiscard]]
+    rediscpp::error run(TSnapshot on_snapshot, TCommand on_command)
+    {
+        stopped_ = false;
+        std::error_code ec;
+        auto stream = make_stream(host_, port_, options_.connection, ec);
+        if (!stream)
+            return rediscpp::error{ec, "The primary isn't available."};
+
+        bool full = false;
+        if (auto err = handshake(*stream, full))
+            return err;
+        if (full)
+        {
+            if (auto err = snapshot(*stream, on_snapshot))
+                return err;
+            if (auto err = ack(*stream))
+                return err;
+        }
+        return replicate(*stream, on_command);
+    }
+
+    // Stops run() from another thread within the ack interval.
+    void stop() noexcept
+    {
+        stopped_ = true;
+    }
+
+    // The replication ID and the offset of the last command.
+    [[nodiscard]]
+    std::string const& replid() const noexcept
+    {
+        return replid_;
+    }
+
+    [[nodiscard]]
+    std::int64_t offset() const noexcept
+    {
+        return offset_;
+    }
+
+    // The number of full resynchronizations.
+    [[nodiscard]]
+    std::uint64_t full_syncs() const noexcept
+    {
+        return full_syncs_;
+    }
+
+private:
+    static constexpr std::size_t chunk_size = 64 * 1024;
+    static constexpr std::size_t mark_size = 40;
+
+    std::string const host_;
+    std::string const port_;
+    replication_options const options_;
+    std::string replid_;
+    std::int64_t offset_;
+    std::uint64_t full_syncs_ = 0;
+    std::atomic<bool> stopped_{false};
+    std::chrono::steady_clock::time_point acked_;
+    // The arguments of a command are views of the buffer.
+    std::string buffer_;
+    std::vector<std::pair<std::size_t, std::size_t>> bounds_;
+    std::vector<std::string_view> args_;
+
+    // REPLCONF and PSYNC are sent at once. The primary which doesn't know
+    // a capability replies with an error, it isn't fatal.
+    rediscpp::error handshake(std::iostream &stream, bool &full)
+    {
+        auto const port = std::to_string(options_.listening_port);
+        auto const offset = std::to_string(offset_ < 0 ? offset_ : offset_ + 1);
+        if (options_.listening_port)
+            execute_no_flush(stream, "replconf", "listening-port", port);
+        execute_no_flush(stream, "replconf", "capa", "eof", "capa", "psync2");
+        execute_no_flush(stream, "psync", replid_, offset);
+        std::flush(stream);
+        if (!stream)
+            return make_error_code(errc::io_error);
+
+        for (int i = options_.listening_port ? 2 : 1 ; i > 0 ; --i)
+        {
+            auto reply = resp::decoding::try_decode<std::string>(stream);
+            if (!reply && resp::detail::decoding::is_fatal(reply.error()))
+                return reply.error();
+        }
+
+        auto reply = resp::decoding::try_decode<std::string>(stream);
+        if (!reply)
+            return reply.error();
+        std::string_view line{*reply};
+        auto const word = next_word(line);
+        if (word == "CONTINUE")
+        {
+            // A new ID after a failover, the offset goes on.
+            if (auto id = next_word(line) ; !id.empty())
+                replid_ = id;
+            return {};
+        }
+        if (word != "FULLRESYNC")
+            return rediscpp::error{make_error_code(errc::bad_format), "Unexpected reply to PSYNC: " + *reply};
+
+        replid_ = next_word(line);
+        auto const number = next_word(line);
+        if (std::from_chars(std::data(number), std::data(number) + std::size(number), offset_).ec != std::errc{})
+            return rediscpp::error{make_error_code(errc::bad_format), "Unexpected reply to PSYNC: " + *reply};
+        full = true;
+        ++full_syncs_;
+        return {};
+    }
+
+    template <typename TSnapshot>
+    rediscpp::error snapshot(std::iostream &stream, TSnapshot &on_snapshot)
+    {
+        // The primary sends newlines while the snapshot is being made.
+        std::string line;
+        do
+        {
+            if (!std::getline(stream, line))
+                return make_error_code(errc::io_error);
+            if (!line.empty() && line.back() == '\r')
+                line.pop_back();
+        }
+        while (line.empty());
+
+        auto const bad = rediscpp::error{make_error_code(errc::bad_format), "Unexpected snapshot header: " + line};
+        if (line.front() != '$')
+            return bad;
+
+        std::string chunk(chunk_size, '\0');
+        if (line.compare(1, 4, "EOF:") == 0)
+        {
+            auto const mark = line.substr(5);
+            if (std::size(mark) != mark_size)
+                return bad;
+            if (!transfer(stream, mark, chunk, on_snapshot))
+                return make_error_code(errc::io_error);
+        }
+        else
+        {
+            std::uint64_t size = 0;
+            if (std::from_chars(std::data(line) + 1, std::data(line) + std::size(line), size).ec != std::errc{})
+                return bad;
+            while (size)
+            {
+                auto const part = static_cast<std::size_t>(std::min<std::uint64_t>(size, chunk_size));
+                if (!stream.read(std::data(chunk), static_cast<std::streamsize>(part)))
+                    return make_error_code(errc::io_error);
+                on_snapshot(std::string_view{std::data(chunk), part});
+                size -= part;
+            }
+        }
+        on_snapshot(std::string_view{});
+        return {};
+    }
+
+    // A diskless transfer ends with the mark. The primary doesn't send
+    // the commands until the first REPLCONF ACK, so whatever is buffered
+    // can be read. The last bytes are held back, they can be the mark.
+    template <typename TSnapshot>
+    bool transfer(std::iostream &stream, std::string_view mark, std::string &chunk, TSnapshot &on_snapshot)
+    {
+        std::string tail;
+        for ( ; ; )
+        {
+            auto const size = stream.readsome(std::data(chunk), static_cast<std::streamsize>(std::size(chunk)));
+            if (!size)
+            {
+                if (!stream || stream.peek() == std::iostream::traits_type::eof())
+                    return false;
+                continue;
+            }
+            tail.append(std::data(chunk), static_cast<std::size_t>(size));
+            if (std::size(tail) < mark_size)
+                continue;
+
+            auto const body = std::size(tail) - mark_size;
+            auto const done = std::string_view{tail}.substr(body) == mark;
+            if (body)
+                on_snapshot(std::string_view{std::data(tail), body});
+            if (done)
+                return true;
+            tail.erase(0, body);
+        }
+    }
+
+    template <typename TCommand>
+    rediscpp::error replicate(std::iostream &stream, TCommand &on_command)
+    {
+        rediscpp::error err;
+        while (!stopped_)
+        {
+            if (stream.rdbuf()->in_avail() <= 0)
+            {
+                auto const deadline = acked_ + options_.ack_interval;
+                if (std::chrono::steady_clock::now() >= deadline)
+                {
+                    if ((err = ack(stream)))
+                        return err;
+                    continue;
+                }
+                if (wait_readable({&stream}, deadline) < 0)
+                    continue;
+            }
+
+            std::size_t size = 0;
+            if (!read(stream, size, err))
+                return err;
+            if (args_.empty())
+                return rediscpp::error{make_error_code(errc::bad_format), "An empty command."};
+
+            // The acknowledged offset doesn't include GETACK, as Redis does.
+            if (same(args_[0], "replconf"))
+            {
+                auto const getack = std::size(args_) > 1 && same(args_[1], "getack");
+                if (getack && (err = ack(stream)))
+                    return err;
+                offset_ += static_cast<std::int64_t>(size);
+                continue;
+            }
+            offset_ += static_cast<std::int64_t>(size);
+            if (!same(args_[0], "ping"))
+                on_command(std::as_const(args_), offset_);
+        }
+        return ack(stream);
+    }
+
+    rediscpp::error ack(std::iostream &stream)
+    {
+        execute_no_flush(stream, "replconf", "ack", std::to_string(offset_));
+        std::flush(stream);
+        acked_ = std::chrono::steady_clock::now();
+        if (!stream)
+            return make_error_code(errc::io_error);
+        return {};
+    }
+
+    // The size is of the command as the primary has sent it, it's needed
+    // for the offset.
+    bool read(std::istream &stream, std::size_t &size, rediscpp::error &err)
+    {
+        buffer_.clear();
+        bounds_.clear();
+        args_.clear();
+
+        resp::decoding::header hdr;
+        if (!hdr.read(stream, err))
+            return false;
+        if (hdr.mark() != resp::detail::marker::array || hdr.is_null())
+            return resp::detail::decoding::unexpected(stream, hdr, err);
+
+        auto const count = static_cast<std::size_t>(hdr.length());
+        size = 3 + digits(count);
+        auto const read = resp::detail::decoding::for_each_item(stream, count, err,
+                [this, &stream, &size, &err] (resp::decoding::header &part, std::size_t)
+                {
+                    if (part.mark() != resp::detail::marker::bulk_string || part.is_null())
+                        return resp::detail::decoding::unexpected(stream, part, err);
+                    auto const offset = std::size(buffer_);
+                    auto const length = static_cast<std::size_t>(part.length());
+                    buffer_.resize(offset + length);
+                    if (length)
+                        stream.read(std::data(buffer_) + offset, static_cast<std::streamsize>(length));
+                    bounds_.emplace_back(offset, length);
+                    size += 5 + digits(length) + length;
+                    return resp::detail::decoding::discard(stream, 2, err);
+                }
+            );
+        if (!read)
+            return false;
+
+        args_.reserve(std::size(bounds_));
+        for (auto const &[offset, length] : bounds_)
+            args_.emplace_back(std::data(buffer_) + offset, length);
+        return true;
+    }
+
+    static std::size_t digits(std::size_t number) noexcept
+    {
+        std::size_t res = 1;
+        while (number >= 10)
+        {
+            number /= 10;
+            ++res;
+        }
+        return res;
+    }
+
+    static bool same(std::string_view name, std::string_view lower) noexcept
+    {
+        return std::size(name) == std::size(lower) &&
+                std::equal(std::begin(name), std::end(name), std::begin(lower),
+                        [] (char a, char b)
+                        {
+                            return std::tolower(static_cast<unsigned char>(a)) == b;
+                        }
+                    );
+    }
+
+    static std::string_view next_word(std::string_view &line) noexcept
+    {
+        auto const begin = line.find_first_not_of(' ');
+        if (begin == std::string_view::npos)
+        {
+            line = {};
+            return {};
+        }
+        auto const end = line.find(' ', begin);
+        auto const res = line.substr(begin, end == std::string_view::npos ? end : end - begin);
+        line = end == std::string_view::npos ? std::string_view{} : line.substr(end);
+        return res;
+    }
+};
+
+}   // namespace rediscpp
+
+#endif  // !REDISCPP_PURE_CORE
+
+#endif  // !REDISCPP_REPLICATION_H_
@@ -0,0 +1,680 @@
+//-------------------------------------------------------------------
+//  redis-cpp
+//  https://github.com/tdv/redis-cpp
+//  Created:     10.2026
+//  Copyright 2020 Dmitry Tkachenko (tkachenkodmitryv@gmail.com)
+//  Distributed under the MIT License
+//  (See accompanying file LICENSE)
+//-------------------------------------------------------------------
+
+#ifndef REDISCPP_RESP_DECODING_H_
+#define REDISCPP_RESP_DECODING_H_
+
+// STD
+#include <algorithm>
+#include <charconv>
+#include <cstdint>
+#include <cstdlib>
+#include <istream>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+// REDIS-CPP
+#include <redis-cpp/detail/config.h>
+#include <redis-cpp/error.h>
+#include <redis-cpp/resp/detail/marker.h>
+
+namespace rediscpp
+{
+inline namespace resp
+{
+namespace decoding
+{
+
+// Describes a user type which is decoded from an array reply
+// item by item. Specialize it with a tuple of member pointers:
+//   template <>
+//   struct struct_traits<my_type>
+//   {
+//       static constexpr auto members = std::make_tuple(&my_type::a, &my_type::b);
+//   };
+// The type can be stored as a hash with hash.h if the traits have
+// the names of the fields as well:
+//       static constexpr std::string_view names[] = {"a", "b"};
+template <typename T>
+struct struct_traits;
+
+// A decoder reads a reply into a value of the type T. It has to provide
+//   static bool get(std::istream &stream, header &hdr, T &result, error &err);
+// and in case of a failure it returns false and leaves the stream at the end
+// of the reply, so the next reply can be read.
+template <typename T, typename = void>
+struct decoder;
+
+class header final
+{
+public:
+    [[nodiscard]]
+    bool read(std::istream &stream, error &err)
+    {
+        auto const mark = stream.get();
+        switch (mark)
+        {
+        case detail::marker::simple_string :
+        case detail::marker::error_message :
+        case detail::marker::integer :
+        case detail::marker::bulk_string :
+        case detail::marker::array :
+            mark_ = static_cast<char>(mark);
+            break;
+        default :
+            return fail(stream, err);
+        }
+
+        std::getline(stream, line_);
+        if (line_.empty() || line_.back() != detail::marker::cr)
+            return fail(stream, err);
+        line_.pop_back(); // removing '\r' from string
+
+        length_ = 0;
+        if (mark_ == detail::marker::bulk_string || mark_ == detail::marker::array)
+        {
+            if (!to_integer(line_, length_))
+                return fail(stream, err);
+        }
+
+        return true;
+    }
+
+    [[nodiscard]]
+    char mark() const noexcept
+    {
+        return mark_;
+    }
+
+    [[nodiscard]]
+    std::string const& line() const noexcept
+    {
+        return line_;
+    }
+
+    [[nodiscard]]
+    std::string&& release_line() noexcept
+    {
+        return std::move(line_);
+    }
+
+    [[nodiscard]]
+    std::int64_t length() const noexcept
+    {
+        return length_;
+    }
+
+    [[nodiscard]]
+    bool is_null() const noexcept
+    {
+        return length_ < 0;
+    }
+
+    template <typename T>
+    [[nodiscard]]
+    static bool to_integer(std::string_view string, T &value) noexcept
+    {
+        auto const *end = std::data(string) + std::size(string);
+        auto const res = std::from_chars(std::data(string), end, value);
+        return res.ec == std::errc{} && res.ptr == end;
+    }
+
+private:
+    char mark_ = 0;
+    std::string line_;
+    std::int64_t length_ = 0;
+
+    static bool fail(std::istream &stream, error &err)
+    {
+        err = make_error_code(stream ? errc::bad_format : errc::io_error);
+        return false;
+    }
+};
+
+}   // namespace decoding
+
+namespace detail
+{
+namespace decoding
+{
+
+using rediscpp::resp::decoding::header;
+using rediscpp::resp::decoding::struct_traits;
+
+// std::istream::ignore peeks a character after the last ignored one
+// and it blocks on a socket, so the data is read into a buffer.
+inline bool discard(std::istream &stream, std::int64_t length, error &err)
+{
+    char buffer[512];
+    while (length > 0 && stream)
+    {
+        auto const size = std::min<std::int64_t>(length, sizeof(buffer));
+        stream.read(buffer, static_cast<std::streamsize>(size));
+        length -= size;
+    }
+    if (stream)
+        return true;
+    err = make_error_code(errc::io_error);
+    return false;
+}
+
+[[nodiscard]]
+inline bool is_fatal(error const &err) noexcept
+{
+    return err.code() == errc::bad_format || err.code() == errc::io_error;
+}
+
+inline bool skip(std::istream &stream, header const &hdr, error &err)
+{
+    if (hdr.mark() == marker::bulk_string && !hdr.is_null())
+        return discard(stream, hdr.length() + 2, err);
+
+    if (hdr.mark() == marker::array && !hdr.is_null())
+    {
+        header item;
+        for (auto count = hdr.length() ; count > 0 ; --count)
+        {
+            if (!item.read(stream, err) || !skip(stream, item, err))
+                return false;
+        }
+    }
+
+    return true;
+}
+
+// A number as a bulk string is read into a buffer on the stack,
+// it's enough for any integer and for the floating point replies.
+constexpr std::size_t number_size = 128;
+
+// Reads a bulk string which is short enough to be a number without
+// an allocation, the buffer is null-terminated. A longer one is skipped
+// and it's a type mismatch.
+inline bool read_number(std::istream &stream, header const &hdr,
+        char (&buffer)[number_size], std::string_view &result, error &err)
+{
+    if (hdr.length() >= static_cast<std::int64_t>(number_size))
+    {
+        if (!skip(stream, hdr, err))
+            return false;
+        err = make_error_code(errc::type_mismatch);
+        return false;
+    }
+    auto const length = static_cast<std::size_t>(hdr.length());
+    stream.read(buffer, static_cast<std::streamsize>(length));
+    buffer[length] = 0;
+    result = std::string_view{buffer, length};
+    return discard(stream, 2, err);
+}
+
+// Sets an error for the reply which can't be decoded into
+// the requested type and skips the rest of the reply.
+inline bool unexpected(std::istream &stream, header const &hdr, error &err)
+{
+    if (hdr.mark() == marker::error_message)
+    {
+        err = {make_error_code(server_error_code(hdr.line())), hdr.line()};
+        return false;
+    }
+    if (!skip(stream, hdr, err))
+        return false;
+    err = make_error_code(hdr.is_null() ? errc::null_value : errc::type_mismatch);
+    return false;
+}
+
+// Reads 'count' items and keeps the stream in a consistent state
+// even if an item can't be decoded: the rest of the items are skipped
+// and the first error is kept.
+template <typename TFunc>
+bool for_each_item(std::istream &stream, std::int64_t count, error &err, TFunc func)
+{
+    header item;
+    for (std::int64_t index = 0 ; index < count ; ++index)
+    {
+        if (!item.read(stream, err))
+            return false;
+        if (err)
+        {
+            error skipped;
+            if (!skip(stream, item, skipped))
+            {
+                err = std::move(skipped);
+                return false;
+            }
+            continue;
+        }
+        if (!func(item, static_cast<std::size_t>(index)) && is_fatal(err))
+            return false;
+    }
+    return !err;
+}
+
+template <typename T>
+using decay_t = std::remove_cv_t<std::remove_reference_t<T>>;
+
+template <typename T, typename = void>
+struct is_struct
+    : std::false_type
+{
+};
+
+template <typename T>
+struct is_struct<T, std::void_t<decltype(struct_traits<T>::members)>>
+    : std::true_type
+{
+};
+
+template <typename T, typename = void>
+struct is_map
+    : std::false_type
+{
+};
+
+template <typename T>
+struct is_map<T, std::void_t<
+        typename T::key_type,
+        typename T::mapped_type,
+        decltype(std::declval<T &>().emplace(
+                std::declval<typename T::key_type>(),
+                std::declval<typename T::mapped_type>()))
+    >>
+    : std::true_type
+{
+};
+
+template <typename T, typename = void>
+struct is_set
+    : std::false_type
+{
+};
+
+template <typename T>
+struct is_set<T, std::void_t<
+        typename T::key_type,
+        decltype(std::declval<T &>().insert(std::declval<typename T::value_type>()))
+    >>
+    : std::bool_constant<!is_map<T>::value>
+{
+};
+
+template <typename T, typename = void>
+struct is_sequence
+    : std::false_type
+{
+};
+
+template <typename T>
+struct is_sequence<T, std::void_t<
+        typename T::value_type,
+        decltype(std::declval<T &>().push_back(std::declval<typename T::value_type>()))
+    >>
+    : std::bool_constant<!std::is_same_v<T, std::string>>
+{
+};
+
+template <typename T, typename = void>
+struct has_reserve
+    : std::false_type
+{
+};
+
+template <typename T>
+struct has_reserve<T, std::void_t<
+        decltype(std::declval<T &>().reserve(std::size_t{}))
+    >>
+    : std::true_type
+{
+};
+
+template <typename T>
+void reserve(T &container, std::int64_t count)
+{
+    if constexpr (has_reserve<T>::value)
+        container.reserve(static_cast<std::size_t>(count));
+}
+
+}   // namespace decoding
+}   // namespace detail
+
+namespace decoding
+{
+
+template <typename T>
+[[nodiscard]]
+bool get(std::istream &stream, header &hdr, T &result, error &err)
+{
+    return decoder<detail::decoding::decay_t<T>>::get(stream, hdr, result, err);
+}
+
+template <typename T>
+[[nodiscard]]
+result<T> try_decode(std::istream &stream)
+{
+    error err;
+    header hdr;
+    if (!hdr.read(stream, err))
+        return err;
+    T value{};
+    if (!get(stream, hdr, value, err))
+        return err;
+    return value;
+}
+
+template <typename T>
+[[nodiscard]]
+T decode(std::istream &stream)
+{
+    return try_decode<T>(stream).value();
+}
+
+template <>
+struct decoder<std::string>
+{
+    static bool get(std::istream &stream, header &hdr, std::string &result, error &err)
+    {
+        switch (hdr.mark())
+        {
+        case detail::marker::simple_string :
+            result = hdr.release_line();
+            return true;
+        case detail::marker::bulk_string :
+            if (hdr.is_null())
+                break;
+            result.resize(static_cast<std::size_t>(hdr.length()));
+            if (hdr.length() > 0)
+                stream.read(std::data(result), static_cast<std::streamsize>(hdr.length()));
+            return detail::decoding::discard(stream, 2, err);
+        default :
+            break;
+        }
+        return detail::decoding::unexpected(stream, hdr, err);
+    }
+};
+
+template <typename T>
+struct decoder<T, std::enable_if_t<std::is_integral_v<T>>>
+{
+    static bool get(std::istream &stream, header &hdr, T &result, error &err)
+    {
+        switch (hdr.mark())
+        {
+        case detail::marker::integer :
+        case detail::marker::simple_string :
+            return convert(hdr.line(), result, err);
+        case detail::marker::bulk_string :
+            if (!hdr.is_null())
+            {
+                char buffer[detail::decoding::number_size];
+                std::string_view string;
+                if (!detail::decoding::read_number(stream, hdr, buffer, string, err))
+                    return false;
+                return convert(string, result, err);
+            }
+            break;
+        default :
+            break;
+        }
+        return detail::decoding::unexpected(stream, hdr, err);
+    }
+
+private:
+    static bool convert(std::string_view string, T &result, error &err)
+    {
+        if constexpr (std::is_same_v<T, bool>)
+        {
+            std::int64_t value = 0;
+            if (header::to_integer(string, value))
+            {
+                result = value != 0;
+                return true;
+            }
+        }
+        else
+        {
+            if (header::to_integer(string, result))
+                return true;
+        }
+        err = make_error_code(errc::type_mismatch);
+        return false;
+    }
+};
+
+template <typename T>
+struct decoder<T, std::enable_if_t<std::is_floating_point_v<T>>>
+{
+    static bool get(std::istream &stream, header &hdr, T &result, error &err)
+    {
+        if (hdr.mark() == detail::marker::integer)
+        {
+            std::int64_t value = 0;
+            if (!header::to_integer(hdr.line(), value))
+            {
+                err = make_error_code(errc::type_mismatch);
+                return false;
+            }
+            result = static_cast<T>(value);
+            return true;
+        }
+
+        if (hdr.mark() == detail::marker::simple_string)
+            return convert(hdr.line(), result, err);
+        if (hdr.mark() != detail::marker::bulk_string || hdr.is_null())
+            return detail::decoding::unexpected(stream, hdr, err);
+
+        char buffer[detail::decoding::number_size];
+        std::string_view string;
+        if (!detail::decoding::read_number(stream, hdr, buffer, string, err))
+            return false;
+        return convert(string, result, err);
+    }
+
+private:
+    // std::from_chars doesn't depend on the locale and accepts "inf" and "nan"
+    // as Redis writes them. std::strtold is left for the standard libraries
+    // without std::from_chars for floating point types, the string has to be
+    // null-terminated for it.
+    static bool convert(std::string_view string, T &result, error &err)
+    {
+        if (!string.empty() && string.front() == '+')
+            string.remove_prefix(1);
+#ifdef __cpp_lib_to_chars
+        auto const *end = std::data(string) + std::size(string);
+        auto const res = std::from_chars(std::data(string), end, result);
+        if (!string.empty() && res.ec == std::errc{} && res.ptr == end)
+            return true;
+#else
+        char *end = nullptr;
+        auto const value = std::strtold(std::data(string), &end);
+        if (!string.empty() && end == std::data(string) + std::size(string))
+        {
+            result = static_cast<T>(value);
+            return true;
+        }
+#endif  // !__cpp_lib_to_chars
+        err = make_error_code(errc::type_mismatch);
+        return false;
+    }
+};
+
+template <typename T>
+struct decoder<std::optional<T>>
+{
+    static bool get(std::istream &stream, header &hdr, std::optional<T> &result, error &err)
+    {
+        if ((hdr.mark() == detail::marker::bulk_string ||
+                hdr.mark() == detail::marker::array) && hdr.is_null())
+        {
+            result.reset();
+            return true;
+        }
+        return decoding::get(stream, hdr, result.emplace(), err);
+    }
+};
+
+template <typename T>
+struct decoder<T, std::enable_if_t<detail::decoding::is_sequence<T>::value>>
+{
+    static bool get(std::istream &stream, header &hdr, T &result, error &err)
+    {
+        if (hdr.mark() != detail::marker::array || hdr.is_null())
+            return detail::decoding::unexpected(stream, hdr, err);
+
+        detail::decoding::reserve(result, hdr.length());
+        return detail::decoding::for_each_item(stream, hdr.length(), err,
+                [&stream, &result, &err] (header &item, std::size_t)
+                {
+                    // The items of std::vector<bool> can't be referred to.
+                    typename T::value_type element{};
+                    if (!decoding::get(stream, item, element, err))
+                        return false;
+                    result.push_back(std::move(element));
+                    return true;
+                }
+            );
+    }
+};
+
+template <typename T>
+struct decoder<T, std::enable_if_t<detail::decoding::is_set<T>::value>>
+{
+    static bool get(std::istream &stream, header &hdr, T &result, error &err)
+    {
+        if (hdr.mark() != detail::marker::array || hdr.is_null())
+            return detail::decoding::unexpected(stream, hdr, err);
+
+        detail::decoding::reserve(result, hdr.length());
+        return detail::decoding::for_each_item(stream, hdr.length(), err,
+                [&stream, &result, &err] (header &item, std::size_t)
+                {
+                    typename T::value_type value{};
+                    if (!decoding::get(stream, item, value, err))
+                        return false;
+                    result.insert(std::move(value));
+                    return true;
+                }
+            );
+    }
+};
+
+// Maps are decoded from a flat array of keys and values
+// as it's returned by HGETALL, CONFIG GET and so on.
+template <typename T>
+struct decoder<T, std::enable_if_t<detail::decoding::is_map<T>::value>>
+{
+    static bool get(std::istream &stream, header &hdr, T &result, error &err)
+    {
+        if (hdr.mark() != detail::marker::array || hdr.is_null() || hdr.length() % 2)
+            return detail::decoding::unexpected(stream, hdr, err);
+
+        detail::decoding::reserve(result, hdr.length() / 2);
+        typename T::key_type key{};
+        return detail::decoding::for_each_item(stream, hdr.length(), err,
+                [&stream, &result, &err, &key] (header &item, std::size_t index)
+                {
+                    if (index % 2 == 0)
+                        return decoding::get(stream, item, key, err);
+                    typename T::mapped_type value{};
+                    if (!decoding::get(stream, item, value, err))
+                        return false;
+                    result.emplace(std::move(key), std::move(value));
+                    return true;
+                }
+            );
+    }
+};
+
+template <typename ... T>
+struct decoder<std::tuple<T ... >>
+{
+    static bool get(std::istream &stream, header &hdr, std::tuple<T ... > &result, error &err)
+    {
+        if (hdr.mark() != detail::marker::array || hdr.is_null() ||
+                hdr.length() != static_cast<std::int64_t>(sizeof ... (T)))
+        {
+            return detail::decoding::unexpected(stream, hdr, err);
+        }
+
+        return detail::decoding::for_each_item(stream, hdr.length(), err,
+                [&stream, &result, &err] (header &item, std::size_t index)
+                {
+                    return set(stream, item, result, err, index,
+                            std::index_sequence_for<T ... >{});
+                }
+            );
+    }
+
+private:
+    template <std::size_t ... I>
+    static bool set(std::istream &stream, header &hdr, std::tuple<T ... > &result,
+            error &err, std::size_t index, std::index_sequence<I ... >)
+    {
+        return ((I == index ? decoding::get(stream, hdr, std::get<I>(result), err) : false) || ... );
+    }
+};
+
+template <typename T1, typename T2>
+struct decoder<std::pair<T1, T2>>
+{
+    static bool get(std::istream &stream, header &hdr, std::pair<T1, T2> &result, error &err)
+    {
+        if (hdr.mark() != detail::marker::array || hdr.is_null() || hdr.length() != 2)
+            return detail::decoding::unexpected(stream, hdr, err);
+
+        return detail::decoding::for_each_item(stream, hdr.length(), err,
+                [&stream, &result, &err] (header &item, std::size_t index)
+                {
+                    return index == 0 ?
+                            decoding::get(stream, item, result.first, err) :
+                            decoding::get(stream, item, result.second, err);
+                }
+            );
+    }
+};
+
+template <typename T>
+struct decoder<T, std::enable_if_t<detail::decoding::is_struct<T>::value>>
+{
+    static bool get(std::istream &stream, header &hdr, T &result, error &err)
+    {
+        constexpr auto count = std::tuple_size_v<detail::decoding::decay_t<
+                decltype(struct_traits<T>::members)>>;
+
+        if (hdr.mark() != detail::marker::array || hdr.is_null() ||
+                hdr.length() != static_cast<std::int64_t>(count))
+        {
+            return detail::decoding::unexpected(stream, hdr, err);
+        }
+
+        return detail::decoding::for_each_item(stream, hdr.length(), err,
+                [&stream, &result, &err] (header &item, std::size_t index)
+                {
+                    return set(stream, item, result, err, index,
+                            std::make_index_sequence<count>{});
+                }
+            );
+    }
+
+private:
+    template <std::size_t ... I>
+    static bool set(std::istream &stream, header &hdr, T &result,
+            error &err, std::size_t index, std::index_sequence<I ... >)
+    {
+        return ((I == index ? decoding::get(stream, hdr,
+                result.*std::get<I>(struct_traits<T>::members), err) : false) || ... );
+    }
+};
+
+}   // namespace decoding
+}   // namespace resp
+}   // namespace rediscpp
+
+#endif  // !REDISCPP_RESP_DECODING_H_
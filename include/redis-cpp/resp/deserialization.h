@@ -66,7 +66,8 @@ public:
     simple_string(std::istream &stream)
     {
         std::getline(stream, value_);
-        value_.pop_back(); // removing '\r' from string
+        if (!value_.empty())
+            value_.pop_back(); // removing '\r' from string
     }
 
     [[nodiscard]]
@@ -85,7 +86,8 @@ public:
     error_message(std::istream &stream)
     {
         std::getline(stream, value_);
-        value_.pop_back(); // removing '\r' from string
+        if (!value_.empty())
+            value_.pop_back(); // removing '\r' from string
     }
 
     [[nodiscard]]
@@ -11,6 +11,7 @@
 #define REDISCPP_RESP_SERIALIZATION_H_
 
 // STD
+#include <cstddef>
 #include <cstdint>
 #include <forward_list>
 #include <ostream>
@@ -189,6 +190,28 @@ public:
     }
 };
 
+// The header of an array whose size is known only at runtime,
+// the items are put after it one by one.
+class array_header final
+{
+public:
+    array_header(std::size_t size) noexcept
+        : size_{size}
+    {
+    }
+
+    void put(std::ostream &stream)
+    {
+        stream << detail::marker::array
+               << size_
+               << detail::marker::cr
+               << detail::marker::lf;
+    }
+
+private:
+    std::size_t size_;
+};
+
 template <typename ... T>
 class array final
 {
@@ -0,0 +1,579 @@
+//-------------------------------------------------------------------
+//  redis-cpp
+//  https://github.com/tdv/redis-cpp
+//  Created:     10.2026
+//  Copyright 2020 Dmitry Tkachenko (tkachenkodmitryv@gmail.com)
+//  Distributed under the MIT License
+//  (See accompanying file LICENSE)
+//-------------------------------------------------------------------
+
+#ifndef REDISCPP_ROUTER_H_
+#define REDISCPP_ROUTER_H_
+
+#ifndef REDISCPP_PURE_CORE
+
+// STD
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+// REDIS-CPP
+#include <redis-cpp/detail/config.h>
+// The header-only transport goes before the RESP headers.
+#include <redis-cpp/stream.h>
+#include <redis-cpp/error.h>
+#include <redis-cpp/execute.h>
+#include <redis-cpp/resp/decoding.h>
+#include <redis-cpp/value.h>
+
+namespace rediscpp
+{
+
+struct router_options final
+{
+    // Options of the connections to the primary and the replicas.
+    stream_options connection;
+    // Reads go to the primary if there is no available replica.
+    bool read_from_primary = true;
+    // Reads go only to the replicas which are connected to the primary
+    // (ROLE on each replica when they are discovered), not to the ones
+    // which are loading the data set or syncing. A replica which replies
+    // LOADING or MASTERDOWN isn't read until the next discovery.
+    bool check_replicas = true;
+    // How often the replicas are discovered again, zero disables it.
+    std::chrono::milliseconds refresh_interval{30000};
+    // A read is sent to a second replica as well if the first one
+    // hasn't replied within the percentile of its latency.
+    // The first reply is taken.
+    bool hedge = false;
+    double hedge_percentile = 0.95;
+    std::chrono::microseconds min_hedge_delay{200};
+};
+
+// Writes go to the primary, read-only commands go to the replicas.
+// The replicas are discovered with ROLE on the primary, the given node may
+// be a replica as well. A replica is chosen at random with a weight inverse
+// to its average latency. The router isn't thread-safe, as the streams.
+class router final
+{
+public:
+    router(std::string_view host, std::string_view port, router_options const &options = {})
+        : options_{options}
+        , primary_host_{host}
+        , primary_port_{port}
+        , primary_{make_stream(host, port, options_.connection)}
+    {
+        refresh();
+    }
+
+    router(router const &) = delete;
+    router& operator = (router const &) = delete;
+
+    // The stream of the primary for writes and any other commands.
+    [[nodiscard]]
+    std::iostream& primary() noexcept
+    {
+        return *primary_;
+    }
+
+    // Read-only commands, e.g. GET, HGETALL, ZRANGE.
+    template <typename ... TArgs>
+    [[nodiscard]]
+    value read(std::string_view name, TArgs && ... args)
+    {
+        return try_read(std::move(name), std::forward<TArgs>(args) ... ).value();
+    }
+
+    template <typename ... TArgs>
+    [[nodiscard]]
+    result<value> try_read(std::string_view name, TArgs && ... args)
+    {
+        return route<value>(std::move(name), std::forward<TArgs>(args) ... );
+    }
+
+    template <typename T, typename ... TArgs>
+    [[nodiscard]]
+    T read_as(std::string_view name, TArgs && ... args)
+    {
+        return try_read_as<T>(std::move(name), std::forward<TArgs>(args) ... ).value();
+    }
+
+    template <typename T, typename ... TArgs>
+    [[nodiscard]]
+    result<T> try_read_as(std::string_view name, TArgs && ... args)
+    {
+        return route<T>(std::move(name), std::forward<TArgs>(args) ... );
+    }
+
+    // Discovers the replicas. Connections to the primary and the known
+    // replicas are kept, broken ones are made again.
+    void refresh()
+    {
+        next_refresh_ = std::chrono::steady_clock::now() + options_.refresh_interval;
+
+        auto primary = discover(*primary_);
+        if (!primary && !*primary_)
+        {
+            primary_ = make_stream(primary_host_, primary_port_, options_.connection);
+            primary = discover(*primary_);
+        }
+        if (!primary)
+            primary.error().raise();
+        if (!primary->is_primary)
+        {
+            primary_host_ = primary->host;
+            primary_port_ = primary->port;
+            primary_ = make_stream(primary_host_, primary_port_, options_.connection);
+            primary = discover(*primary_);
+            if (!primary)
+                primary.error().raise();
+        }
+
+        std::vector<node> nodes;
+        nodes.reserve(std::size(primary->replicas));
+        for (auto &address : primary->replicas)
+        {
+            auto iter = std::find_if(std::begin(nodes_), std::end(nodes_),
+                    [&address] (node const &item)
+                    { return item.host == address.first && item.port == address.second; }
+                );
+            if (iter != std::end(nodes_) && iter->stream)
+            {
+                nodes.push_back(std::move(*iter));
+                continue;
+            }
+
+            node item;
+            item.host = std::move(address.first);
+            item.port = std::move(address.second);
+            std::error_code ec;
+            item.stream = make_stream(item.host, item.port, options_.connection, ec);
+            nodes.push_back(std::move(item));
+        }
+        nodes_ = std::move(nodes);
+        check();
+    }
+
+    // The number of replicas which can be read.
+    [[nodiscard]]
+    std::size_t replicas() const noexcept
+    {
+        return static_cast<std::size_t>(std::count_if(std::begin(nodes_), std::end(nodes_),
+                [] (node const &item) { return item.stream && item.healthy; }));
+    }
+
+    // The number of reads which were sent to a second replica.
+    [[nodiscard]]
+    std::uint64_t hedged() const noexcept
+    {
+        return hedged_;
+    }
+
+private:
+    using clock = std::chrono::steady_clock;
+
+    // Reads aren't hedged until the percentile is known.
+    static constexpr std::size_t min_samples = 16;
+    static constexpr std::size_t max_samples = 128;
+
+    struct node final
+    {
+        std::string host;
+        std::string port;
+        // It's nullptr if the connection is broken.
+        std::shared_ptr<std::iostream> stream;
+        // The replica is connected to its primary.
+        bool healthy = false;
+        // Replies to the hedged reads which have been answered by another replica.
+        std::size_t stale = 0;
+        // Average latency in microseconds, zero until the first reply.
+        double latency = 0;
+        std::vector<double> samples;
+        std::size_t next_sample = 0;
+        clock::duration hedge_delay{};
+    };
+
+    struct role final
+    {
+        bool is_primary = false;
+        // The primary of a replica and the state of the link to it.
+        std::string host;
+        std::string port;
+        std::string state;
+        std::vector<std::pair<std::string, std::string>> replicas;
+    };
+
+    router_options options_;
+    std::string primary_host_;
+    std::string primary_port_;
+    std::shared_ptr<std::iostream> primary_;
+    std::vector<node> nodes_;
+    clock::time_point next_refresh_;
+    std::uint64_t hedged_ = 0;
+    std::minstd_rand random_{std::random_device{}()};
+    std::vector<std::iostream *> waiting_;
+
+    template <typename T, typename ... TArgs>
+    result<T> route(std::string_view name, TArgs const & ... args)
+    {
+        if (options_.refresh_interval.count() > 0 && clock::now() >= next_refresh_)
+        {
+            try
+            {
+                refresh();
+            }
+            catch (std::exception const &)
+            {
+                // The known replicas are used until the primary is available.
+            }
+        }
+
+        drain();
+
+        auto *first = pick(nullptr);
+        if (!first)
+        {
+            if (!options_.read_from_primary)
+                return errc::io_error;
+            return read_primary<T>(name, args ... );
+        }
+
+        execute_no_flush(*first->stream, name, args ... );
+        std::flush(*first->stream);
+        auto const first_start = clock::now();
+        if (!*first->stream)
+        {
+            first->stream.reset();
+            return options_.read_from_primary ? read_primary<T>(name, args ... ) :
+                    result<T>{errc::io_error};
+        }
+
+        auto *winner = first;
+        auto start = first_start;
+        if (options_.hedge)
+        {
+            auto *second = std::size(first->samples) < min_samples ? nullptr : pick(first);
+            if (second && wait(first, nullptr, first_start + first->hedge_delay) < 0)
+            {
+                execute_no_flush(*second->stream, name, args ... );
+                std::flush(*second->stream);
+                auto const second_start = clock::now();
+                ++hedged_;
+
+                if (wait(first, second, clock::time_point::max()) == 1)
+                {
+                    // The latency of the first one is at least this long.
+                    measure(*first, clock::now() - first_start);
+                    ++first->stale;
+                    winner = second;
+                    start = second_start;
+                }
+                else
+                {
+                    ++second->stale;
+                }
+            }
+        }
+
+        auto reply = decode<T>(*winner->stream);
+        if (unavailable(reply))
+        {
+            winner->healthy = false;
+            if (!options_.read_from_primary)
+                return reply;
+            return read_primary<T>(name, args ... );
+        }
+        if (reply || !resp::detail::decoding::is_fatal(reply.error()))
+        {
+            measure(*winner, clock::now() - start);
+            return reply;
+        }
+
+        // Reads are idempotent, so a read of a broken replica is repeated.
+        winner->stream.reset();
+        if (!options_.read_from_primary)
+            return reply;
+        return read_primary<T>(name, args ... );
+    }
+
+    template <typename T, typename ... TArgs>
+    result<T> read_primary(std::string_view name, TArgs const & ... args)
+    {
+        execute_no_flush(*primary_, name, args ... );
+        std::flush(*primary_);
+        return decode<T>(*primary_);
+    }
+
+    template <typename T>
+    static result<T> decode(std::istream &stream)
+    {
+        if constexpr (std::is_same_v<T, value>)
+        {
+            return value::try_read(stream);
+        }
+        else
+        {
+            if (!stream)
+                return errc::io_error;
+            return resp::decoding::try_decode<T>(stream);
+        }
+    }
+
+    // The replica is loading the data set or has lost its primary
+    // and doesn't serve stale data.
+    template <typename T>
+    static bool unavailable(result<T> const &reply)
+    {
+        std::string_view message;
+        if constexpr (std::is_same_v<T, value>)
+        {
+            if (!reply || !reply->is_error_message())
+                return false;
+            message = reply->as_error_message();
+        }
+        else
+        {
+            if (reply || reply.error().code() != errc::server_error)
+                return false;
+            message = reply.error().message();
+        }
+        return message.substr(0, 7) == "LOADING" || message.substr(0, 10) == "MASTERDOWN";
+    }
+
+    // ROLE is sent to all the replicas at once. The replicas with stale
+    // replies keep their state, they aren't read until the replies come.
+    void check()
+    {
+        for (auto &item : nodes_)
+        {
+            if (!options_.check_replicas)
+                item.healthy = true;
+            else if (item.stream && !item.stale)
+                put_role(*item.stream);
+        }
+        if (!options_.check_replicas)
+            return;
+
+        for (auto &item : nodes_)
+        {
+            if (!item.stream || item.stale)
+                continue;
+            auto state = read_role(*item.stream);
+            if (state)
+            {
+                item.healthy = !state->is_primary && state->state == "connected";
+                continue;
+            }
+            if (resp::detail::decoding::is_fatal(state.error()))
+            {
+                item.healthy = false;
+                item.stream.reset();
+                continue;
+            }
+            // E.g. ROLE isn't allowed to the user, the replica is taken as it is.
+            item.healthy = !unavailable(state);
+        }
+    }
+
+    // Stale replies which have already come are skipped.
+    void drain()
+    {
+        for (auto &item : nodes_)
+        {
+            while (item.stream && item.stale && !wait(&item, nullptr, clock::now()))
+            {
+                error err;
+                resp::decoding::header hdr;
+                if (!hdr.read(*item.stream, err) ||
+                        !resp::detail::decoding::skip(*item.stream, hdr, err))
+                {
+                    item.stream.reset();
+                    item.stale = 0;
+                    break;
+                }
+                --item.stale;
+            }
+        }
+    }
+
+    int wait(node *first, node *second, clock::time_point deadline)
+    {
+        waiting_.clear();
+        waiting_.push_back(first->stream.get());
+        if (second)
+            waiting_.push_back(second->stream.get());
+        return wait_readable(waiting_, deadline);
+    }
+
+    // Replicas with stale replies aren't taken until the replies come.
+    node* pick(node const *exclude)
+    {
+        double total = 0;
+        for (auto const &item : nodes_)
+        {
+            if (&item != exclude && item.stream && item.healthy && !item.stale)
+                total += weight(item);
+        }
+        if (total <= 0)
+            return nullptr;
+
+        auto point = std::uniform_real_distribution<double>{0, total}(random_);
+        node *last = nullptr;
+        for (auto &item : nodes_)
+        {
+            if (&item == exclude || !item.stream || !item.healthy || item.stale)
+                continue;
+            last = &item;
+            point -= weight(item);
+            if (point < 0)
+                break;
+        }
+        return last;
+    }
+
+    // Replicas without replies yet get the largest weight, so they are tried first.
+    static double weight(node const &item) noexcept
+    {
+        return 1.0 / (item.latency + 1.0);
+    }
+
+    void measure(node &item, clock::duration latency)
+    {
+        auto const sample = std::chrono::duration<double, std::micro>{latency}.count();
+        item.latency = item.latency > 0 ? item.latency + (sample - item.latency) / 8 : sample;
+
+        if (std::size(item.samples) < max_samples)
+            item.samples.push_back(sample);
+        else
+            item.samples[item.next_sample] = sample;
+        item.next_sample = (item.next_sample + 1) % max_samples;
+
+        // The percentile is updated once in a while, it's O(n).
+        if (std::size(item.samples) < min_samples || item.next_sample % min_samples)
+            return;
+
+        auto sorted = item.samples;
+        auto const rank = static_cast<std::size_t>(std::clamp(options_.hedge_percentile, 0.0, 1.0) *
+                static_cast<double>(std::size(sorted) - 1));
+        std::nth_element(std::begin(sorted), std::begin(sorted) + static_cast<std::ptrdiff_t>(rank),
+                std::end(sorted));
+        item.hedge_delay = std::max<clock::duration>(
+                std::chrono::duration_cast<clock::duration>(
+                        std::chrono::duration<double, std::micro>{sorted[rank]}),
+                options_.min_hedge_delay);
+    }
+
+    static result<role> discover(std::iostream &stream)
+    {
+        put_role(stream);
+        return read_role(stream);
+    }
+
+    static void put_role(std::iostream &stream)
+    {
+        execute_no_flush(stream, "role");
+        std::flush(stream);
+    }
+
+    // ROLE of a primary: [master, offset, [[host, port, offset], ...]],
+    // of a replica: [slave, host, port, state, offset].
+    static result<role> read_role(std::istream &stream)
+    {
+        if (!stream)
+            return errc::io_error;
+
+        role res;
+        error err;
+        resp::decoding::header hdr;
+        if (!hdr.read(stream, err))
+            return err;
+        if (hdr.mark() != resp::detail::marker::array || hdr.is_null() || hdr.length() < 3)
+        {
+            resp::detail::decoding::unexpected(stream, hdr, err);
+            return err;
+        }
+
+        std::string kind;
+        std::int64_t port = 0;
+        auto const read = resp::detail::decoding::for_each_item(stream, hdr.length(), err,
+                [&] (resp::decoding::header &item, std::size_t index)
+                {
+                    if (index == 0)
+                    {
+                        if (!resp::decoding::get(stream, item, kind, err))
+                            return false;
+                        res.is_primary = kind == "master";
+                        return true;
+                    }
+                    if (res.is_primary && index == 2)
+                        return read_replicas(stream, item, res.replicas, err);
+                    if (!res.is_primary && index == 1)
+                        return resp::decoding::get(stream, item, res.host, err);
+                    if (!res.is_primary && index == 2)
+                    {
+                        if (!resp::decoding::get(stream, item, port, err))
+                            return false;
+                        res.port = std::to_string(port);
+                        return true;
+                    }
+                    if (!res.is_primary && index == 3)
+                        return resp::decoding::get(stream, item, res.state, err);
+                    return resp::detail::decoding::skip(stream, item, err);
+                }
+            );
+        if (!read)
+            return err;
+        if (kind != "master" && kind != "slave")
+            return error{make_error_code(errc::type_mismatch), "Unexpected role: " + kind};
+        return res;
+    }
+
+    static bool read_replicas(std::istream &stream, resp::decoding::header &hdr,
+            std::vector<std::pair<std::string, std::string>> &replicas, error &err)
+    {
+        if (hdr.mark() != resp::detail::marker::array || hdr.is_null())
+            return resp::detail::decoding::unexpected(stream, hdr, err);
+
+        return resp::detail::decoding::for_each_item(stream, hdr.length(), err,
+                [&stream, &replicas, &err] (resp::decoding::header &item, std::size_t)
+                {
+                    if (item.mark() != resp::detail::marker::array || item.length() < 2)
+                        return resp::detail::decoding::unexpected(stream, item, err);
+
+                    auto &address = replicas.emplace_back();
+                    std::int64_t port = 0;
+                    return resp::detail::decoding::for_each_item(stream, item.length(), err,
+                            [&stream, &address, &port, &err] (resp::decoding::header &field, std::size_t index)
+                            {
+                                if (index == 0)
+                                    return resp::decoding::get(stream, field, address.first, err);
+                                if (index == 1)
+                                {
+                                    if (!resp::decoding::get(stream, field, port, err))
+                                        return false;
+                                    address.second = std::to_string(port);
+                                    return true;
+                                }
+                                return resp::detail::decoding::skip(stream, field, err);
+                            }
+                        );
+                }
+            );
+    }
+};
+
+}   // namespace rediscpp
+
+#endif  // !REDISCPP_PURE_CORE
+
+#endif  // !REDISCPP_ROUTER_H_
@@ -0,0 +1,338 @@
+//-------------------------------------------------------------------
+//  redis-cpp
+//  https://github.com/tdv/redis-cpp
+//  Created:     10.2026
+//  Copyright 2020 Dmitry Tkachenko (tkachenkodmitryv@gmail.com)
+//  Distributed under the MIT License
+//  (See accompanying file LICENSE)
+//-------------------------------------------------------------------
+
+#ifndef REDISCPP_SCAN_H_
+#define REDISCPP_SCAN_H_
+
+// STD
+#include <algorithm>
+#include <cctype>
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+#include <iterator>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+// REDIS-CPP
+#include <redis-cpp/detail/config.h>
+#include <redis-cpp/error.h>
+#include <redis-cpp/resp/decoding.h>
+#include <redis-cpp/resp/serialization.h>
+
+namespace rediscpp
+{
+
+struct scan_options final
+{
+    // SCAN, or HSCAN, SSCAN and ZSCAN of the key.
+    std::string command = "scan";
+    std::string key;
+    std::string match;
+    // A hint of the page size, zero is for the server's default.
+    std::size_t count = 0;
+    // The type of the keys, SCAN only.
+    std::string type;
+};
+
+// Iterates the items of a SCAN family command page by page. The request for
+// the next page is sent as soon as a page is read, so the server works on it
+// while the page is being consumed. With several streams, e.g. one per node,
+// all of them are scanned at once and their pages are taken in turn.
+// The items of HSCAN and ZSCAN go in pairs: a field and its value,
+// a member and its score. The streams mustn't be used for other
+// commands until the scanner is destroyed.
+class scanner final
+{
+public:
+    class iterator final
+    {
+    public:
+        using iterator_category = std::input_iterator_tag;
+        using value_type = std::string_view;
+        using difference_type = std::ptrdiff_t;
+        using pointer = std::string_view const *;
+        using reference = std::string_view const &;
+
+        iterator() noexcept = default;
+
+        [[nodiscard]]
+        reference operator * () const noexcept
+        {
+            return owner_->items_[index_];
+        }
+
+        [[nodiscard]]
+        pointer operator -> () const noexcept
+        {
+            return &owner_->items_[index_];
+        }
+
+        iterator& operator ++ ()
+        {
+            if (++index_ == std::size(owner_->items_))
+            {
+                index_ = 0;
+                if (!owner_->next())
+                    owner_ = nullptr;
+            }
+            return *this;
+        }
+
+        [[nodiscard]]
+        bool operator == (iterator const &other) const noexcept
+        {
+            return owner_ == other.owner_ && index_ == other.index_;
+        }
+
+        [[nodiscard]]
+        bool operator != (iterator const &other) const noexcept
+        {
+            return !(*this == other);
+        }
+
+    private:
+        friend class scanner;
+
+        explicit iterator(scanner *owner) noexcept
+            : owner_{owner}
+        {
+        }
+
+        scanner *owner_ = nullptr;
+        std::size_t index_ = 0;
+    };
+
+    explicit scanner(std::iostream &stream, scan_options options = {})
+        : scanner{std::vector<std::iostream *>{&stream}, std::move(options)}
+    {
+    }
+
+    scanner(std::vector<std::iostream *> const &streams, scan_options options = {})
+        : options_{std::move(options)}
+    {
+        nodes_.reserve(std::size(streams));
+        for (auto *stream : streams)
+            nodes_.push_back(node{stream});
+        for (auto &item : nodes_)
+            request(item);
+    }
+
+    scanner(scanner const &) = delete;
+    scanner& operator = (scanner const &) = delete;
+
+    // The replies in flight are read, so the streams can be used further.
+    ~scanner() noexcept
+    {
+        try
+        {
+            for (auto &item : nodes_)
+            {
+                if (!item.pending)
+                    continue;
+                rediscpp::error err;
+                resp::decoding::header hdr;
+                if (hdr.read(*item.stream, err))
+                    resp::detail::decoding::skip(*item.stream, hdr, err);
+            }
+        }
+        catch (...)
+        {
+        }
+    }
+
+    // Reads the next page which isn't empty, false at the end or on an error.
+    [[nodiscard]]
+    bool next()
+    {
+        items_.clear();
+        while (!error_)
+        {
+            auto *item = pick();
+            if (!item)
+                return false;
+            if (!read(*item))
+                break;
+            if (item->cursor == "0")
+                item->done = true;
+            else
+                request(*item);
+            if (!items_.empty())
+                return true;
+        }
+        items_.clear();
+        for (auto &item : nodes_)
+            item.done = true;
+        return false;
+    }
+
+    // The items of the page, valid until the next page is read.
+    [[nodiscard]]
+    std::vector<std::string_view> const& page() const noexcept
+    {
+        return items_;
+    }
+
+    // Set if the scan has stopped because of an error.
+    [[nodiscard]]
+    rediscpp::error const& error() const noexcept
+    {
+        return error_;
+    }
+
+    // The scan goes on from the current page, it's a single pass.
+    [[nodiscard]]
+    iterator begin()
+    {
+        if (items_.empty() && !next())
+            return {};
+        return iterator{this};
+    }
+
+    [[nodiscard]]
+    iterator end() const noexcept
+    {
+        return {};
+    }
+
+private:
+    struct node final
+    {
+        std::iostream *stream = nullptr;
+        std::string cursor = "0";
+        bool pending = false;
+        bool done = false;
+    };
+
+    scan_options const options_;
+    std::vector<node> nodes_;
+    std::size_t turn_ = 0;
+    // The items are views of the buffer which holds a page.
+    std::string buffer_;
+    std::vector<std::pair<std::size_t, std::size_t>> bounds_;
+    std::vector<std::string_view> items_;
+    rediscpp::error error_;
+
+    node* pick() noexcept
+    {
+        for (std::size_t i = 0 ; i < std::size(nodes_) ; ++i)
+        {
+            auto &item = nodes_[turn_++ % std::size(nodes_)];
+            if (!item.done)
+                return &item;
+        }
+        return nullptr;
+    }
+
+    static bool same(std::string_view name, std::string_view lower) noexcept
+    {
+        return std::size(name) == std::size(lower) &&
+                std::equal(std::begin(name), std::end(name), std::begin(lower),
+                        [] (char a, char b)
+                        {
+                            return std::tolower(static_cast<unsigned char>(a)) == b;
+                        }
+                    );
+    }
+
+    void request(node &item)
+    {
+        auto const count = options_.count ? std::to_string(options_.count) : std::string{};
+        auto const with_key = !same(options_.command, "scan");
+        std::size_t const size = 2 + with_key +
+                (options_.match.empty() ? 0 : 2) +
+                (options_.count ? 2 : 0) +
+                (options_.type.empty() ? 0 : 2);
+
+        auto &stream = *item.stream;
+        put(stream, resp::serialization::array_header{size});
+        put(stream, resp::serialization::bulk_string{options_.command});
+        if (with_key)
+            put(stream, resp::serialization::bulk_string{options_.key});
+        put(stream, resp::serialization::bulk_string{item.cursor});
+        if (!options_.match.empty())
+        {
+            put(stream, resp::serialization::bulk_string{"match"});
+            put(stream, resp::serialization::bulk_string{options_.match});
+        }
+        if (options_.count)
+        {
+            put(stream, resp::serialization::bulk_string{"count"});
+            put(stream, resp::serialization::bulk_string{count});
+        }
+        if (!options_.type.empty())
+        {
+            put(stream, resp::serialization::bulk_string{"type"});
+            put(stream, resp::serialization::bulk_string{options_.type});
+        }
+        std::flush(stream);
+        item.pending = true;
+        if (!stream)
+            error_ = make_error_code(errc::io_error);
+    }
+
+    // [cursor, [item ...]], the items are read into the buffer with no copies
+    // per item.
+    bool read(node &item)
+    {
+        auto &stream = *item.stream;
+        item.pending = false;
+        buffer_.clear();
+        bounds_.clear();
+
+        resp::decoding::header hdr;
+        if (!hdr.read(stream, error_))
+            return false;
+        if (hdr.mark() != resp::detail::marker::array || hdr.is_null() || hdr.length() != 2)
+            return resp::detail::decoding::unexpected(stream, hdr, error_);
+
+        auto const read = resp::detail::decoding::for_each_item(stream, 2, error_,
+                [this, &stream, &item] (resp::decoding::header &part, std::size_t index)
+                {
+                    if (index == 0)
+                        return resp::decoding::get(stream, part, item.cursor, error_);
+                    if (part.mark() != resp::detail::marker::array || part.is_null())
+                        return resp::detail::decoding::unexpected(stream, part, error_);
+                    return resp::detail::decoding::for_each_item(stream, part.length(), error_,
+                            [this, &stream] (resp::decoding::header &element, std::size_t)
+                            {
+                                return put_item(stream, element);
+                            }
+                        );
+                }
+            );
+        if (!read)
+            return false;
+
+        items_.reserve(std::size(bounds_));
+        for (auto const &[offset, length] : bounds_)
+            items_.emplace_back(std::data(buffer_) + offset, length);
+        return true;
+    }
+
+    bool put_item(std::istream &stream, resp::decoding::header const &hdr)
+    {
+        if (hdr.mark() != resp::detail::marker::bulk_string || hdr.is_null())
+            return resp::detail::decoding::unexpected(stream, hdr, error_);
+
+        auto const offset = std::size(buffer_);
+        auto const length = static_cast<std::size_t>(hdr.length());
+        buffer_.resize(offset + length);
+        if (length)
+            stream.read(std::data(buffer_) + offset, static_cast<std::streamsize>(length));
+        bounds_.emplace_back(offset, length);
+        return resp::detail::decoding::discard(stream, 2, error_);
+    }
+};
+
+}   // namespace rediscpp
+
+#endif  // !REDISCPP_SCAN_H_
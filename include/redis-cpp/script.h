@@ -0,0 +1,359 @@
+//-------------------------------------------------------------------
+//  redis-cpp
+//  https://github.com/tdv/redis-cpp
+//  Created:     10.2026
+//  Copyright 2020 Dmitry Tkachenko (tkachenkodmitryv@gmail.com)
+//  Distributed under the MIT License
+//  (See accompanying file LICENSE)
+//-------------------------------------------------------------------
+
+#ifndef REDISCPP_SCRIPT_H_
+#define REDISCPP_SCRIPT_H_
+
+// STD
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+// REDIS-CPP
+#include <redis-cpp/detail/config.h>
+#include <redis-cpp/error.h>
+#include <redis-cpp/execute.h>
+#include <redis-cpp/resp/decoding.h>
+#include <redis-cpp/value.h>
+
+namespace rediscpp
+{
+
+// A Lua script which is called by its SHA1 with EVALSHA, so the body is sent
+// only once per server. If the server doesn't have the script (NOSCRIPT),
+// e.g. after a restart or a failover, SCRIPT LOAD and EVALSHA are sent again
+// in one pipeline. The first `keys` of the arguments are the keys.
+// Server errors are returned as errors, not as values.
+class script final
+{
+public:
+    explicit script(std::string body)
+        : body_{std::move(body)}
+        , sha_{sha1(body_)}
+    {
+    }
+
+    [[nodiscard]]
+    std::string const& body() const noexcept
+    {
+        return body_;
+    }
+
+    [[nodiscard]]
+    std::string const& sha() const noexcept
+    {
+        return sha_;
+    }
+
+    template <typename ... TArgs>
+    [[nodiscard]]
+    result<value> try_execute(std::iostream &stream, std::size_t keys, TArgs && ... args) const
+    {
+        return call(stream, keys, [&stream] { return read_value(stream); }, args ... );
+    }
+
+    template <typename T, typename ... TArgs>
+    [[nodiscard]]
+    result<T> try_execute_as(std::iostream &stream, std::size_t keys, TArgs && ... args) const
+    {
+        return call(stream, keys, [&stream] { return resp::decoding::try_decode<T>(stream); }, args ... );
+    }
+
+    template <typename ... TArgs>
+    [[nodiscard]]
+    value execute(std::iostream &stream, std::size_t keys, TArgs && ... args) const
+    {
+        return try_execute(stream, keys, args ... ).value();
+    }
+
+    template <typename T, typename ... TArgs>
+    [[nodiscard]]
+    T execute_as(std::iostream &stream, std::size_t keys, TArgs && ... args) const
+    {
+        return try_execute_as<T>(stream, keys, args ... ).value();
+    }
+
+    // Loads the script ahead of the first call, e.g. on each server of a pool.
+    // The scripts are cached by a server, not by a connection.
+    [[nodiscard]]
+    error load(std::iostream &stream) const
+    {
+        execute_no_flush(stream, "script", "load", body_);
+        std::flush(stream);
+        return loaded(stream);
+    }
+
+    // Loads the scripts onto each of the streams, e.g. the connections to
+    // the nodes of a router or the leases of a pool; the items of 'streams'
+    // are dereferenced as pointers. SCRIPT LOAD is written to all of them
+    // before any reply is read, so the nodes load the scripts at once.
+    // Returns an error per stream in their order: the first failed load
+    // or none if the node has all the scripts.
+    template <typename TStreams, typename TScripts>
+    [[nodiscard]]
+    static std::vector<error> preload(TStreams const &streams, TScripts const &scripts)
+    {
+        for (auto const &item : streams)
+        {
+            std::iostream &stream = *item;
+            for (script const &code : scripts)
+                execute_no_flush(stream, "script", "load", code.body_);
+            std::flush(stream);
+        }
+
+        std::vector<error> res;
+        for (auto const &item : streams)
+        {
+            std::iostream &stream = *item;
+            error first;
+            for (script const &code : scripts)
+            {
+                (void)code;
+                auto err = loaded(stream);
+                if (err && !first)
+                    first = std::move(err);
+                // The rest of the replies can't be read from a broken stream.
+                if (!stream)
+                    break;
+            }
+            res.push_back(std::move(first));
+        }
+        return res;
+    }
+
+private:
+    friend class library;
+
+    std::string const body_;
+    std::string const sha_;
+
+    template <typename TRead, typename ... TArgs>
+    auto call(std::iostream &stream, std::size_t keys, TRead read, TArgs const & ... args) const
+            -> decltype(read())
+    {
+        auto const count = std::to_string(keys);
+        return run(stream,
+                [&] { execute_no_flush(stream, "evalsha", sha_, count, args ... ); },
+                [] (auto const &err) { return err.code() == errc::no_script; },
+                [&] { execute_no_flush(stream, "script", "load", body_); },
+                std::move(read)
+            );
+    }
+
+    // Sends a call and, if the code is missing on the server, loads the code
+    // and sends the call again. The reply to loading goes first.
+    template <typename TSend, typename TMissing, typename TLoad, typename TRead>
+    static auto run(std::iostream &stream, TSend send, TMissing missing, TLoad load, TRead read)
+            -> decltype(read())
+    {
+        send();
+        std::flush(stream);
+        if (!stream)
+            return errc::io_error;
+        auto res = read();
+        if (res || !missing(res.error()))
+            return res;
+
+        load();
+        send();
+        std::flush(stream);
+        if (!stream)
+            return errc::io_error;
+        auto err = loaded(stream);
+        res = read();
+        if (err)
+            return err;
+        return res;
+    }
+
+    [[nodiscard]]
+    static error loaded(std::iostream &stream)
+    {
+        auto reply = read_value(stream);
+        if (!reply)
+            return reply.error();
+        return {};
+    }
+
+    [[nodiscard]]
+    static result<value> read_value(std::iostream &stream)
+    {
+        auto reply = value::try_read(stream);
+        if (reply && reply->is_error_message())
+        {
+            auto const message = reply->as_error_message();
+            return error{make_error_code(server_error_code(message)), std::string{message}};
+        }
+        return reply;
+    }
+
+    // The hex digest, as SCRIPT LOAD returns it.
+    [[nodiscard]]
+    static std::string sha1(std::string_view data)
+    {
+        std::uint32_t h[5] = {0x67452301, 0xEFCDAB89, 0x98BADCFE, 0x10325476, 0xC3D2E1F0};
+        auto const rotl = [] (std::uint32_t x, int n) { return (x << n) | (x >> (32 - n)); };
+
+        std::string msg{data};
+        msg.push_back('\x80');
+        while (std::size(msg) % 64 != 56)
+            msg.push_back('\0');
+        auto const bits = static_cast<std::uint64_t>(std::size(data)) * 8;
+        for (int i = 7 ; i >= 0 ; --i)
+            msg.push_back(static_cast<char>((bits >> (i * 8)) & 0xFF));
+
+        for (std::size_t chunk = 0 ; chunk < std::size(msg) ; chunk += 64)
+        {
+            std::uint32_t w[80];
+            for (std::size_t i = 0 ; i < 16 ; ++i)
+            {
+                auto const *p = reinterpret_cast<unsigned char const *>(std::data(msg) + chunk + i * 4);
+                w[i] = (std::uint32_t{p[0]} << 24) | (std::uint32_t{p[1]} << 16) |
+                        (std::uint32_t{p[2]} << 8) | std::uint32_t{p[3]};
+            }
+            for (std::size_t i = 16 ; i < 80 ; ++i)
+                w[i] = rotl(w[i - 3] ^ w[i - 8] ^ w[i - 14] ^ w[i - 16], 1);
+
+            auto a = h[0], b = h[1], c = h[2], d = h[3], e = h[4];
+            for (std::size_t i = 0 ; i < 80 ; ++i)
+            {
+                std::uint32_t f = 0;
+                std::uint32_t k = 0;
+                if (i < 20)
+                {
+                    f = (b & c) | (~b & d);
+                    k = 0x5A827999;
+                }
+                else if (i < 40)
+                {
+                    f = b ^ c ^ d;
+                    k = 0x6ED9EBA1;
+                }
+                else if (i < 60)
+                {
+                    f = (b & c) | (b & d) | (c & d);
+                    k = 0x8F1BBCDC;
+                }
+                else
+                {
+                    f = b ^ c ^ d;
+                    k = 0xCA62C1D6;
+                }
+                auto const temp = rotl(a, 5) + f + e + k + w[i];
+                e = d;
+                d = c;
+                c = rotl(b, 30);
+                b = a;
+                a = temp;
+            }
+            h[0] += a;
+            h[1] += b;
+            h[2] += c;
+            h[3] += d;
+            h[4] += e;
+        }
+
+        static char const digits[] = "0123456789abcdef";
+        std::string res;
+        res.reserve(40);
+        for (auto const word : h)
+        {
+            for (int shift = 28 ; shift >= 0 ; shift -= 4)
+                res.push_back(digits[(word >> shift) & 0xF]);
+        }
+        return res;
+    }
+};
+
+// A library of Redis functions (Redis 7), the code starts with
+// "#!lua name=<library>". The functions are called with FCALL, the library
+// is loaded with FUNCTION LOAD REPLACE if the server doesn't have it.
+class library final
+{
+public:
+    explicit library(std::string code)
+        : code_{std::move(code)}
+    {
+    }
+
+    [[nodiscard]]
+    std::string const& code() const noexcept
+    {
+        return code_;
+    }
+
+    template <typename ... TArgs>
+    [[nodiscard]]
+    result<value> try_call(std::iostream &stream, std::string_view function,
+            std::size_t keys, TArgs && ... args) const
+    {
+        return invoke(stream, function, keys, [&stream] { return script::read_value(stream); }, args ... );
+    }
+
+    template <typename T, typename ... TArgs>
+    [[nodiscard]]
+    result<T> try_call_as(std::iostream &stream, std::string_view function,
+            std::size_t keys, TArgs && ... args) const
+    {
+        return invoke(stream, function, keys,
+                [&stream] { return resp::decoding::try_decode<T>(stream); }, args ... );
+    }
+
+    template <typename ... TArgs>
+    [[nodiscard]]
+    value call(std::iostream &stream, std::string_view function, std::size_t keys, TArgs && ... args) const
+    {
+        return try_call(stream, function, keys, args ... ).value();
+    }
+
+    template <typename T, typename ... TArgs>
+    [[nodiscard]]
+    T call_as(std::iostream &stream, std::string_view function, std::size_t keys, TArgs && ... args) const
+    {
+        return try_call_as<T>(stream, function, keys, args ... ).value();
+    }
+
+    [[nodiscard]]
+    error load(std::iostream &stream) const
+    {
+        execute_no_flush(stream, "function", "load", "replace", code_);
+        std::flush(stream);
+        return script::loaded(stream);
+    }
+
+private:
+    std::string const code_;
+
+    template <typename TRead, typename ... TArgs>
+    auto invoke(std::iostream &stream, std::string_view function, std::size_t keys,
+            TRead read, TArgs const & ... args) const
+            -> decltype(read())
+    {
+        auto const count = std::to_string(keys);
+        return script::run(stream,
+                [&] { execute_no_flush(stream, "fcall", function, count, args ... ); },
+                [] (auto const &err)
+                {
+                    auto const message = err.message();
+                    return err.code() == errc::server_error &&
+                            message.substr(0, 22) == "ERR Function not found";
+                },
+                [&] { execute_no_flush(stream, "function", "load", "replace", code_); },
+                std::move(read)
+            );
+    }
+};
+
+}   // namespace rediscpp
+
+#endif  // !REDISCPP_SCRIPT_H_
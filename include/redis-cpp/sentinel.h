@@ -0,0 +1,499 @@
+//-------------------------------------------------------------------
+//  redis-cpp
+//  https://github.com/tdv/redis-cpp
+//  Created:     10.2026
+//  Copyright 2020 Dmitry Tkachenko (tkachenkodmitryv@gmail.com)
+//  Distributed under the MIT License
+//  (See accompanying file LICENSE)
+//-------------------------------------------------------------------
+
+#ifndef REDISCPP_SENTINEL_H_
+#define REDISCPP_SENTINEL_H_
+
+#ifndef REDISCPP_PURE_CORE
+
+// STD
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <thread>
+#include <utility>
+#include <vector>
+
+// REDIS-CPP
+#include <redis-cpp/detail/config.h>
+// The header-only transport goes before the RESP headers.
+#include <redis-cpp/stream.h>
+#include <redis-cpp/error.h>
+#include <redis-cpp/execute.h>
+#include <redis-cpp/resp/decoding.h>
+#include <redis-cpp/subscriber.h>
+
+namespace rediscpp
+{
+
+struct sentinel_options final
+{
+    // Options of the connections to the primary.
+    stream_options connection;
+    // Options of the connections to the sentinels, e.g. a short timeout.
+    stream_options sentinel_connection;
+    // The resolved primary is checked with ROLE, so a sentinel which
+    // hasn't seen the failover yet doesn't send the clients to a replica.
+    bool check_role = true;
+    // How often the watcher thread checks the subscription to the
+    // announcements and subscribes to another sentinel if it's lost.
+    std::chrono::milliseconds watch_interval{1000};
+};
+
+// Resolves the primary of a monitored master by its name with
+// SENTINEL GET-MASTER-ADDR-BY-NAME and follows +switch-master,
+// so a failover is seen as soon as the sentinels announce it.
+// The sentinel which has replied is asked first next time.
+// The watcher thread keeps the subscription and resolves the primary
+// when it's asked to by request_resolve.
+// All the methods are thread-safe.
+class sentinel final
+{
+public:
+    // Host and port.
+    using address = std::pair<std::string, std::string>;
+    // Called when the primary is switched by the thread which has seen it.
+    using handler = std::function<void (address const &)>;
+
+    sentinel(std::vector<address> sentinels, std::string master_name,
+            sentinel_options const &options = {})
+        : sentinels_{std::move(sentinels)}
+        , master_name_{std::move(master_name)}
+        , options_{options}
+    {
+        if (sentinels_.empty())
+            throw std::invalid_argument{"[rediscpp::sentinel] There are no sentinels."};
+        resolve();
+        thread_ = std::thread{[this] { run(); }};
+    }
+
+    ~sentinel() noexcept
+    {
+        {
+            std::lock_guard<std::mutex> lock{thread_mutex_};
+            stopped_ = true;
+        }
+        wake_.notify_all();
+        if (thread_.joinable())
+            thread_.join();
+    }
+
+    sentinel(sentinel const &) = delete;
+    sentinel& operator = (sentinel const &) = delete;
+
+    // The primary which has been resolved or announced last.
+    [[nodiscard]]
+    address primary() const
+    {
+        std::lock_guard<std::mutex> lock{mutex_};
+        return primary_;
+    }
+
+    // It's changed each time the primary is switched.
+    [[nodiscard]]
+    std::uint64_t generation() const noexcept
+    {
+        return generation_.load(std::memory_order_acquire);
+    }
+
+    // Asks the sentinels for the primary. The watcher is subscribed
+    // again if its sentinel is unavailable.
+    address resolve()
+    {
+        std::lock_guard<std::mutex> resolve_lock{resolve_mutex_};
+
+        std::vector<address> sentinels;
+        {
+            std::lock_guard<std::mutex> lock{mutex_};
+            sentinels = sentinels_;
+        }
+
+        error last = make_error_code(errc::io_error);
+        for (std::size_t i = 0 ; i < std::size(sentinels) ; ++i)
+        {
+            auto res = ask(sentinels[i]);
+            if (!res)
+            {
+                last = res.error();
+                continue;
+            }
+
+            {
+                std::lock_guard<std::mutex> lock{mutex_};
+                auto iter = std::find(std::begin(sentinels_), std::end(sentinels_), sentinels[i]);
+                if (iter != std::end(sentinels_))
+                    std::rotate(std::begin(sentinels_), iter, iter + 1);
+            }
+            watch(sentinels[i]);
+            update(*res);
+            return std::move(*res);
+        }
+
+        last.raise();
+    }
+
+    // The primary is resolved by the watcher thread, the caller doesn't wait.
+    void request_resolve() noexcept
+    {
+        {
+            std::lock_guard<std::mutex> lock{thread_mutex_};
+            resolve_requested_ = true;
+        }
+        wake_.notify_one();
+    }
+
+    // Connects to the primary. If it fails, the primary is resolved
+    // again, e.g. the announcement could be lost.
+    [[nodiscard]]
+    std::shared_ptr<std::iostream> make_stream()
+    {
+        auto target = primary();
+        std::error_code ec;
+        if (auto stream = rediscpp::make_stream(target.first, target.second, options_.connection, ec))
+            return stream;
+
+        target = resolve();
+        return rediscpp::make_stream(target.first, target.second, options_.connection);
+    }
+
+    // A handler must not call resolve.
+    void on_switch(handler func)
+    {
+        std::lock_guard<std::mutex> lock{mutex_};
+        handlers_.push_back(std::move(func));
+    }
+
+private:
+    std::mutex resolve_mutex_;
+    mutable std::mutex mutex_;
+    std::vector<address> sentinels_;
+    std::string const master_name_;
+    sentinel_options const options_;
+    address primary_;
+    std::atomic<std::uint64_t> generation_{0};
+    std::vector<handler> handlers_;
+    // The watcher goes last, so it's stopped before the rest is destroyed.
+    address watched_;
+    std::unique_ptr<subscriber> watcher_;
+
+    std::mutex thread_mutex_;
+    std::condition_variable wake_;
+    bool resolve_requested_ = false;
+    bool stopped_ = false;
+    std::thread thread_;
+
+    void run()
+    {
+        std::unique_lock<std::mutex> lock{thread_mutex_};
+        for (;;)
+        {
+            wake_.wait_for(lock, options_.watch_interval,
+                    [this] { return stopped_ || resolve_requested_; });
+            if (stopped_)
+                return;
+            auto const requested = std::exchange(resolve_requested_, false);
+            lock.unlock();
+
+            // The next request or check tries again.
+            try
+            {
+                if (requested)
+                    resolve();
+                else
+                    rewatch();
+            }
+            catch (...)
+            {
+            }
+
+            lock.lock();
+        }
+    }
+
+    // Subscribes to another sentinel if the watched one is lost. A switch
+    // could be announced meanwhile, so the primary is asked for again.
+    void rewatch()
+    {
+        std::vector<address> sentinels;
+        {
+            std::lock_guard<std::mutex> lock{mutex_};
+            if (watcher_ && watcher_->running())
+                return;
+            sentinels = sentinels_;
+        }
+
+        for (auto const &target : sentinels)
+        {
+            if (watch(target))
+            {
+                resolve();
+                return;
+            }
+        }
+    }
+
+    [[nodiscard]]
+    result<address> ask(address const &target) const
+    {
+        std::error_code ec;
+        auto stream = rediscpp::make_stream(target.first, target.second,
+                options_.sentinel_connection, ec);
+        if (!stream)
+            return error{ec};
+
+        auto reply = try_execute_as<std::vector<std::string>>(*stream,
+                "sentinel", "get-master-addr-by-name", master_name_);
+        if (!reply)
+            return reply.error();
+        if (std::size(*reply) != 2)
+            return error{make_error_code(errc::type_mismatch), "Unexpected address of the master."};
+
+        address res{std::move((*reply)[0]), std::move((*reply)[1])};
+        if (!options_.check_role)
+            return res;
+
+        // The primary takes its own credentials and database, the check
+        // is limited by the timeout of the sentinels if there's one
+        // and doesn't pin the thread.
+        auto check = options_.connection;
+        if (options_.sentinel_connection.timeout.count() > 0)
+            check.timeout = options_.sentinel_connection.timeout;
+        check.cpu = -1;
+        auto primary = rediscpp::make_stream(res.first, res.second, check, ec);
+        if (!primary)
+            return error{ec};
+        auto role = get_role(*primary);
+        if (!role)
+            return role.error();
+        if (*role != "master")
+            return error{make_error_code(errc::server_error), "The node isn't a master yet."};
+        return res;
+    }
+
+    // The first item of ROLE, the rest depends on the role.
+    [[nodiscard]]
+    static result<std::string> get_role(std::iostream &stream)
+    {
+        execute_no_flush(stream, "role");
+        std::flush(stream);
+
+        error err;
+        resp::decoding::header hdr;
+        if (!hdr.read(stream, err))
+            return err;
+        if (hdr.mark() != resp::detail::marker::array || hdr.is_null() || hdr.length() < 1)
+        {
+            resp::detail::decoding::unexpected(stream, hdr, err);
+            return err;
+        }
+
+        std::string role;
+        auto const read = resp::detail::decoding::for_each_item(stream, hdr.length(), err,
+                [&stream, &role, &err] (resp::decoding::header &item, std::size_t index)
+                {
+                    if (index == 0)
+                        return resp::decoding::get(stream, item, role, err);
+                    return resp::detail::decoding::skip(stream, item, err);
+                }
+            );
+        if (!read)
+            return err;
+        return role;
+    }
+
+    bool watch(address const &target)
+    {
+        {
+            std::lock_guard<std::mutex> lock{mutex_};
+            if (watcher_ && watcher_->running() && watched_ == target)
+                return true;
+        }
+
+        std::error_code ec;
+        auto stream = rediscpp::make_stream(target.first, target.second,
+                options_.sentinel_connection, ec);
+        if (!stream)
+            return false;
+        auto watcher = std::make_unique<subscriber>(std::move(stream));
+        watcher->subscribe("+switch-master",
+                [this] (subscriber::message const &msg) { switched(msg.payload); });
+
+        std::unique_ptr<subscriber> old;
+        {
+            std::lock_guard<std::mutex> lock{mutex_};
+            old = std::move(watcher_);
+            watcher_ = std::move(watcher);
+            watched_ = target;
+        }
+        return true;
+    }
+
+    // <master name> <old ip> <old port> <new ip> <new port>
+    void switched(std::string_view payload)
+    {
+        std::string_view fields[5];
+        std::size_t count = 0;
+        while (count < std::size(fields) && !payload.empty())
+        {
+            auto const end = std::min(payload.find(' '), std::size(payload));
+            fields[count++] = payload.substr(0, end);
+            payload.remove_prefix(std::min(end + 1, std::size(payload)));
+        }
+        if (count != std::size(fields) || fields[0] != master_name_)
+            return;
+
+        update(address{std::string{fields[3]}, std::string{fields[4]}});
+    }
+
+    void update(address const &target)
+    {
+        std::vector<handler> handlers;
+        {
+            std::lock_guard<std::mutex> lock{mutex_};
+            if (primary_ == target)
+                return;
+            primary_ = target;
+            generation_.fetch_add(1, std::memory_order_acq_rel);
+            handlers = handlers_;
+        }
+
+        for (auto const &func : handlers)
+            func(target);
+    }
+};
+
+// Keeps idle connections to the primary of a sentinel. A connection
+// which is in use when the primary is switched stays with its user,
+// so the pipelined commands and their replies aren't lost; the lease
+// becomes stale and the connection is closed when it's returned.
+// A broken connection makes the watcher thread resolve the primary,
+// not waiting for the announcement.
+class sentinel_pool final
+{
+public:
+    class lease final
+    {
+    public:
+        lease(lease &&) noexcept = default;
+        lease& operator = (lease &&) noexcept = default;
+
+        ~lease() noexcept
+        {
+            if (pool_ && stream_)
+                pool_->release(std::move(stream_), generation_);
+        }
+
+        [[nodiscard]]
+        std::iostream& operator * () const noexcept
+        {
+            return *stream_;
+        }
+
+        [[nodiscard]]
+        std::iostream* operator -> () const noexcept
+        {
+            return stream_.get();
+        }
+
+        // The primary has been switched since the connection was leased,
+        // it still goes to the old one. The replies to the sent commands
+        // can be read, the new commands should go through another lease.
+        [[nodiscard]]
+        bool stale() const noexcept
+        {
+            return pool_ && pool_->sentinel_.generation() != generation_;
+        }
+
+    private:
+        friend class sentinel_pool;
+
+        lease(sentinel_pool &pool, std::shared_ptr<std::iostream> stream, std::uint64_t generation)
+            : pool_{&pool}
+            , stream_{std::move(stream)}
+            , generation_{generation}
+        {
+        }
+
+        sentinel_pool *pool_ = nullptr;
+        std::shared_ptr<std::iostream> stream_;
+        std::uint64_t generation_ = 0;
+    };
+
+    // The pool has to outlive its leases.
+    explicit sentinel_pool(sentinel &source, std::size_t size = 8)
+        : sentinel_{source}
+        , size_{size}
+    {
+    }
+
+    sentinel_pool(sentinel_pool const &) = delete;
+    sentinel_pool& operator = (sentinel_pool const &) = delete;
+
+    [[nodiscard]]
+    lease acquire()
+    {
+        auto const generation = sentinel_.generation();
+        {
+            std::lock_guard<std::mutex> lock{mutex_};
+            if (generation_ != generation)
+            {
+                idle_.clear();
+                generation_ = generation;
+            }
+            if (!idle_.empty())
+            {
+                auto stream = std::move(idle_.back());
+                idle_.pop_back();
+                return lease{*this, std::move(stream), generation};
+            }
+        }
+        return lease{*this, sentinel_.make_stream(), generation};
+    }
+
+private:
+    sentinel &sentinel_;
+    std::size_t const size_;
+    std::mutex mutex_;
+    std::vector<std::shared_ptr<std::iostream>> idle_;
+    std::uint64_t generation_ = 0;
+
+    void release(std::shared_ptr<std::iostream> stream, std::uint64_t generation) noexcept
+    {
+        if (!*stream)
+        {
+            if (generation == sentinel_.generation())
+                sentinel_.request_resolve();
+            return;
+        }
+
+        std::lock_guard<std::mutex> lock{mutex_};
+        if (generation == generation_ && generation == sentinel_.generation() &&
+                std::size(idle_) < size_)
+        {
+            idle_.push_back(std::move(stream));
+        }
+    }
+};
+
+}   // namespace rediscpp
+
+#endif  // !REDISCPP_PURE_CORE
+
+#endif  // !REDISCPP_SENTINEL_H_
@@ -0,0 +1,137 @@
+//-------------------------------------------------------------------
+//  redis-cpp
+//  https://github.com/tdv/redis-cpp
+//  Created:     10.2026
+//  Copyright 2020 Dmitry Tkachenko (tkachenkodmitryv@gmail.com)
+//  Distributed under the MIT License
+//  (See accompanying file LICENSE)
+//-------------------------------------------------------------------
+
+#ifndef REDISCPP_SINGLE_FLIGHT_H_
+#define REDISCPP_SINGLE_FLIGHT_H_
+
+// STD
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+
+// REDIS-CPP
+#include <redis-cpp/detail/config.h>
+#include <redis-cpp/error.h>
+#include <redis-cpp/execute.h>
+#include <redis-cpp/value.h>
+
+namespace rediscpp
+{
+
+// Concurrent identical commands share one request: the first caller sends it,
+// the others wait for its reply. The reply is shared by all of them and
+// isn't copied. The commands are identical if they're serialized into
+// the same bytes. It's for reads only, a write would be applied once
+// for all the callers. The target is called from many threads,
+// e.g. auto_pipeline, and has to provide
+// try_execute(name, args ...) -> result<value>.
+template <typename TTarget>
+class single_flight final
+{
+public:
+    using reply = std::shared_ptr<value const>;
+
+    explicit single_flight(TTarget &target) noexcept
+        : target_{target}
+    {
+    }
+
+    single_flight(single_flight const &) = delete;
+    single_flight& operator = (single_flight const &) = delete;
+
+    template <typename ... TArgs>
+    [[nodiscard]]
+    reply execute(std::string_view name, TArgs && ... args)
+    {
+        return try_execute(std::move(name), std::forward<TArgs>(args) ... ).value();
+    }
+
+    template <typename ... TArgs>
+    [[nodiscard]]
+    result<reply> try_execute(std::string_view name, TArgs && ... args)
+    {
+        std::ostringstream command;
+        execute_no_flush(command, name, args ... );
+        auto const key = command.str();
+
+        std::unique_lock<std::mutex> lock{mutex_};
+        auto [iter, first] = flights_.try_emplace(key);
+        if (!first)
+        {
+            auto current = iter->second;
+            ++coalesced_;
+            current->done.wait(lock, [&current] { return current->res.has_value(); });
+            return *current->res;
+        }
+
+        auto current = std::make_shared<flight>();
+        iter->second = current;
+        lock.unlock();
+
+        std::optional<result<reply>> res;
+        try
+        {
+            auto received = target_.try_execute(std::move(name), std::forward<TArgs>(args) ... );
+            if (received)
+                res.emplace(std::make_shared<value const>(std::move(*received)));
+            else
+                res.emplace(received.error());
+        }
+        catch (...)
+        {
+            complete(key, *current, errc::io_error);
+            throw;
+        }
+        complete(key, *current, *res);
+        return std::move(*res);
+    }
+
+    // The number of calls which have waited for another call's reply.
+    [[nodiscard]]
+    std::uint64_t coalesced() const
+    {
+        std::lock_guard<std::mutex> lock{mutex_};
+        return coalesced_;
+    }
+
+private:
+    struct flight final
+    {
+        std::condition_variable done;
+        std::optional<result<reply>> res;
+    };
+
+    TTarget &target_;
+    mutable std::mutex mutex_;
+    std::unordered_map<std::string, std::shared_ptr<flight>> flights_;
+    std::uint64_t coalesced_ = 0;
+
+    // The command is removed before the waiters are woken up, so the next
+    // call sends it again instead of taking a reply which may be stale.
+    void complete(std::string const &key, flight &current, result<reply> const &res)
+    {
+        {
+            std::lock_guard<std::mutex> lock{mutex_};
+            current.res.emplace(res);
+            flights_.erase(key);
+        }
+        current.done.notify_all();
+    }
+};
+
+}   // namespace rediscpp
+
+#endif  // !REDISCPP_SINGLE_FLIGHT_H_
@@ -13,9 +13,15 @@
 #ifndef REDISCPP_PURE_CORE
 
 // STD
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
 #include <iosfwd>
 #include <memory>
+#include <string>
 #include <string_view>
+#include <system_error>
+#include <vector>
 
 // REDIS-CPP
 #include <redis-cpp/detail/config.h>
@@ -23,10 +29,103 @@
 namespace rediscpp
 {
 
+struct stream_options final
+{
+    // Sizes of the stream buffers. Zero is for the default size.
+    std::size_t read_buffer_size = 0;
+    std::size_t write_buffer_size = 0;
+
+    // SO_RCVBUF and SO_SNDBUF. Zero is for the system default.
+    int receive_buffer_size = 0;
+    int send_buffer_size = 0;
+
+    // TCP only options.
+    bool no_delay = true;
+    bool quick_ack = false;         // TCP_QUICKACK, Linux only
+    int busy_poll = 0;              // SO_BUSY_POLL in microseconds, Linux only
+    bool keep_alive = false;
+    int keep_alive_idle = 0;        // TCP_KEEPIDLE in seconds, Linux only
+    int keep_alive_interval = 0;    // TCP_KEEPINTVL in seconds, Linux only
+    int keep_alive_count = 0;       // TCP_KEEPCNT, Linux only
+
+    // Pins the thread which creates the stream to the CPU. Linux only.
+    int cpu = -1;
+
+    // Timeout of connecting and of each read and write, zero is for none.
+    // Name resolution isn't limited by it.
+    std::chrono::milliseconds timeout{0};
+
+    // The handshake is pipelined: AUTH, SELECT and CLIENT SETNAME
+    // are sent at once and take a single round trip.
+    std::string user;
+    std::string password;
+    std::int64_t database = 0;
+    std::string client_name;
+};
+
+// The host can be a Unix domain socket path like "unix:///path/to/redis.sock",
+// the port is ignored in this case.
+// The stream buffer can be read by one thread and written by another one
+// at the same time, e.g. through a separate std::ostream{stream->rdbuf()}.
+// The stream object itself isn't thread-safe.
 [[nodiscard]]
 std::shared_ptr<std::iostream> make_stream(
         std::string_view host, std::string_view port);
 
+// Returns nullptr and sets 'ec' if the connection can't be established.
+[[nodiscard]]
+std::shared_ptr<std::iostream> make_stream(
+        std::string_view host, std::string_view port,
+        std::error_code &ec) noexcept;
+
+[[nodiscard]]
+std::shared_ptr<std::iostream> make_stream(
+        std::string_view host, std::string_view port,
+        stream_options const &options);
+
+[[nodiscard]]
+std::shared_ptr<std::iostream> make_stream(
+        std::string_view host, std::string_view port,
+        stream_options const &options, std::error_code &ec) noexcept;
+
+// The functions below also take a stream made by make_stream and wrapped
+// into a tapped_stream, e.g. by monitor_stream or record_stream.
+
+// Returns the last transport error of a stream created by make_stream.
+// The stream doesn't throw on a transport error, it becomes bad as it did
+// before; a connection closed by the server just fails it.
+[[nodiscard]]
+std::error_code get_error(std::iostream const &stream) noexcept;
+
+// Sets the deadline of the next commands on a stream created by make_stream,
+// time_point::max() removes it. A read or a write which isn't completed
+// by the deadline fails with std::errc::timed_out (see get_error).
+// The reply could come later, so the stream fails all the next operations
+// and a new stream has to be made; a late reply is never taken for
+// the reply to another command.
+void set_deadline(std::iostream &stream,
+        std::chrono::steady_clock::time_point deadline) noexcept;
+
+// Changes the timeout of each read and write (stream_options::timeout)
+// with the same semantics as the deadline. Zero disables it.
+void set_timeout(std::iostream &stream,
+        std::chrono::steady_clock::duration timeout) noexcept;
+
+// Wakes up a thread which waits for a reply on a stream made by make_stream
+// without the server: the read side of the socket is shut down, so
+// the reads see the end of the stream. The stream fails all the next
+// operations and a new stream has to be made.
+void shutdown_read(std::iostream &stream) noexcept;
+
+// Waits until one of the streams made by make_stream can be read without
+// waiting or the deadline expires. Returns the index of the stream or -1.
+// Nothing is read, so unlike set_deadline a timeout leaves the streams
+// usable. A broken stream is ready, reading it fails. With io_uring
+// the streams have to be made by the same thread.
+[[nodiscard]]
+int wait_readable(std::vector<std::iostream *> const &streams,
+        std::chrono::steady_clock::time_point deadline);
+
 }   // namespace rediscpp
 
 #ifdef REDISCPP_HEADER_ONLY
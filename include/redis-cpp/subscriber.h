@@ -0,0 +1,444 @@
+//-------------------------------------------------------------------
+//  redis-cpp
+//  https://github.com/tdv/redis-cpp
+//  Created:     10.2026
+//  Copyright 2020 Dmitry Tkachenko (tkachenkodmitryv@gmail.com)
+//  Distributed under the MIT License
+//  (See accompanying file LICENSE)
+//-------------------------------------------------------------------
+
+#ifndef REDISCPP_SUBSCRIBER_H_
+#define REDISCPP_SUBSCRIBER_H_
+
+// STD
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <thread>
+#include <utility>
+#include <vector>
+
+// REDIS-CPP
+#include <redis-cpp/detail/config.h>
+// The header-only transport goes before the RESP headers.
+#include <redis-cpp/stream.h>
+#include <redis-cpp/error.h>
+#include <redis-cpp/execute.h>
+#include <redis-cpp/resp/decoding.h>
+
+namespace rediscpp
+{
+
+// What the reader does when the queue of received messages is full.
+enum class overflow_policy
+{
+    // Stops reading, the messages are buffered by the kernel and
+    // the server (see client-output-buffer-limit in redis.conf).
+    block,
+    // Drops the received message.
+    drop_newest,
+    // Drops the oldest queued message.
+    drop_oldest
+};
+
+struct subscriber_options final
+{
+    // The queue has a fixed size, its messages are reused.
+    std::size_t queue_size = 64 * 1024;
+    // Max number of messages taken by the dispatcher at once.
+    std::size_t batch_size = 256;
+    overflow_policy overflow = overflow_policy::block;
+};
+
+// Owns a stream in the subscribed state. A reader thread decodes messages
+// right into the queue and a dispatcher thread calls the handlers.
+// Message buffers are moved between the queue and the dispatcher's batch,
+// so there are no allocations per message when the buffers are warmed up.
+class subscriber final
+{
+public:
+    struct message final
+    {
+        // It's empty if the message isn't received by a pattern.
+        std::string pattern;
+        std::string channel;
+        std::string payload;
+    };
+
+    // Exceptions thrown by a handler are ignored.
+    using handler = std::function<void (message const &)>;
+
+    // The stream must allow reading and writing from different threads,
+    // as the streams created by make_stream do.
+    explicit subscriber(std::shared_ptr<std::iostream> stream,
+            subscriber_options const &options = {})
+        : stream_{std::move(stream)}
+        , writer_{stream_->rdbuf()}
+        , overflow_{options.overflow}
+        , queue_(std::max<std::size_t>(options.queue_size, 1))
+        , batch_(std::max<std::size_t>(options.batch_size, 1))
+    {
+        reader_ = std::thread{[this] { read(); }};
+        dispatcher_ = std::thread{[this] { dispatch(); }};
+    }
+
+    subscriber(subscriber const &) = delete;
+    subscriber& operator = (subscriber const &) = delete;
+
+    ~subscriber() noexcept
+    {
+        try
+        {
+            stop();
+        }
+        catch (...)
+        {
+        }
+    }
+
+    void subscribe(std::string_view channel, handler func)
+    {
+        add(channels_, "subscribe", channel, std::move(func));
+    }
+
+    void psubscribe(std::string_view pattern, handler func)
+    {
+        add(patterns_, "psubscribe", pattern, std::move(func));
+    }
+
+    // Sharded Pub/Sub, Redis 7.0 or higher.
+    void ssubscribe(std::string_view channel, handler func)
+    {
+        add(shard_channels_, "ssubscribe", channel, std::move(func));
+    }
+
+    void unsubscribe(std::string_view channel)
+    {
+        remove(channels_, "unsubscribe", channel);
+    }
+
+    void punsubscribe(std::string_view pattern)
+    {
+        remove(patterns_, "punsubscribe", pattern);
+    }
+
+    void sunsubscribe(std::string_view channel)
+    {
+        remove(shard_channels_, "sunsubscribe", channel);
+    }
+
+    // Stops reading and waits for the queued messages to be dispatched.
+    // Don't call it from a handler.
+    void stop()
+    {
+        if (!stopped_.exchange(true))
+        {
+#ifndef REDISCPP_PURE_CORE
+            // The reader is woken up even if the server doesn't reply.
+            shutdown_read(*stream_);
+#endif  // !REDISCPP_PURE_CORE
+            // Other streams are woken up by any reply.
+            std::lock_guard<std::mutex> lock{write_mutex_};
+            execute_no_flush(writer_, "ping");
+            std::flush(writer_);
+        }
+
+        {
+            std::lock_guard<std::mutex> lock{queue_mutex_};
+            not_full_.notify_all();
+        }
+
+        if (reader_.joinable())
+            reader_.join();
+        if (dispatcher_.joinable())
+            dispatcher_.join();
+    }
+
+    // It's false when the reader is stopped or the stream is broken.
+    [[nodiscard]]
+    bool running() const
+    {
+        std::lock_guard<std::mutex> lock{queue_mutex_};
+        return !reader_done_;
+    }
+
+    [[nodiscard]]
+    std::error_code error() const
+    {
+        std::lock_guard<std::mutex> lock{queue_mutex_};
+        return error_;
+    }
+
+    // The number of messages dropped due to the overflow policy.
+    [[nodiscard]]
+    std::uint64_t dropped() const noexcept
+    {
+        return dropped_.load(std::memory_order_relaxed);
+    }
+
+private:
+    enum class source
+    {
+        channel,
+        pattern,
+        shard_channel
+    };
+
+    struct entry final
+    {
+        source from = source::channel;
+        message msg;
+    };
+
+    using handlers = std::map<std::string, std::shared_ptr<handler>, std::less<>>;
+
+    std::shared_ptr<std::iostream> stream_;
+    // The reader thread uses the get area of the stream buffer only and
+    // the commands are written into its put area under the write mutex.
+    // The stream buffers of make_stream keep the two areas independent,
+    // std::ostream is separate to have its own state.
+    std::ostream writer_;
+    std::mutex write_mutex_;
+
+    overflow_policy const overflow_;
+    std::atomic<bool> stopped_{false};
+    std::atomic<std::uint64_t> dropped_{0};
+
+    mutable std::mutex queue_mutex_;
+    std::condition_variable not_empty_;
+    std::condition_variable not_full_;
+    std::vector<entry> queue_;
+    std::size_t head_ = 0;
+    std::size_t size_ = 0;
+    bool dispatcher_waiting_ = false;
+    bool reader_done_ = false;
+    std::error_code error_;
+
+    std::mutex handlers_mutex_;
+    handlers channels_;
+    handlers patterns_;
+    handlers shard_channels_;
+
+    std::vector<entry> batch_;
+    std::vector<std::shared_ptr<handler>> targets_;
+
+    std::thread reader_;
+    std::thread dispatcher_;
+
+    void add(handlers &map, std::string_view command, std::string_view name, handler func)
+    {
+        {
+            std::lock_guard<std::mutex> lock{handlers_mutex_};
+            map.insert_or_assign(std::string{name}, std::make_shared<handler>(std::move(func)));
+        }
+        send(command, name);
+    }
+
+    void remove(handlers &map, std::string_view command, std::string_view name)
+    {
+        {
+            std::lock_guard<std::mutex> lock{handlers_mutex_};
+            if (auto iter = map.find(name) ; iter != std::end(map))
+                map.erase(iter);
+        }
+        send(command, name);
+    }
+
+    void send(std::string_view command, std::string_view name)
+    {
+        std::lock_guard<std::mutex> lock{write_mutex_};
+        execute_no_flush(writer_, command, name);
+        std::flush(writer_);
+        if (!writer_)
+            rediscpp::error{make_error_code(errc::io_error)}.raise();
+    }
+
+    void read()
+    {
+        auto &stream = *stream_;
+        resp::decoding::header hdr;
+        std::string kind;
+        entry incoming;
+        rediscpp::error err;
+
+        while (!stopped_.load(std::memory_order_acquire))
+        {
+            if (!hdr.read(stream, err))
+                break;
+            if (!read_message(stream, hdr, kind, incoming, err))
+            {
+                if (resp::detail::decoding::is_fatal(err))
+                    break;
+                err = {};
+                continue;
+            }
+            if (!push(incoming))
+                break;
+        }
+
+        std::lock_guard<std::mutex> lock{queue_mutex_};
+        reader_done_ = true;
+        if (!stopped_.load(std::memory_order_acquire))
+            error_ = err ? err.code() : make_error_code(errc::io_error);
+        not_empty_.notify_one();
+    }
+
+    // Message frames are decoded into the entry, the rest are skipped.
+    static bool read_message(std::istream &stream, resp::decoding::header &hdr,
+            std::string &kind, entry &incoming, rediscpp::error &err)
+    {
+        if (hdr.mark() != resp::detail::marker::array || hdr.length() < 1)
+        {
+            resp::detail::decoding::skip(stream, hdr, err);
+            return false;
+        }
+
+        auto const count = hdr.length();
+        if (!hdr.read(stream, err))
+            return false;
+        if (!resp::decoding::get(stream, hdr, kind, err))
+        {
+            // The rest of the items are skipped since the error is set.
+            if (!resp::detail::decoding::is_fatal(err))
+                resp::detail::decoding::for_each_item(stream, count - 1, err,
+                        [] (auto const &, std::size_t) { return true; });
+            return false;
+        }
+
+        auto &msg = incoming.msg;
+        std::string *fields[3] = {};
+        std::size_t field_count = 0;
+        if ((kind == "message" || kind == "smessage") && count == 3)
+        {
+            incoming.from = kind == "message" ? source::channel : source::shard_channel;
+            msg.pattern.clear();
+            fields[field_count++] = &msg.channel;
+            fields[field_count++] = &msg.payload;
+        }
+        else if (kind == "pmessage" && count == 4)
+        {
+            incoming.from = source::pattern;
+            fields[field_count++] = &msg.pattern;
+            fields[field_count++] = &msg.channel;
+            fields[field_count++] = &msg.payload;
+        }
+
+        auto const read = resp::detail::decoding::for_each_item(stream, count - 1, err,
+                [&stream, &fields, field_count, &err] (auto &item, std::size_t index)
+                {
+                    if (index < field_count)
+                        return resp::decoding::get(stream, item, *fields[index], err);
+                    return resp::detail::decoding::skip(stream, item, err);
+                }
+            );
+
+        return read && field_count != 0;
+    }
+
+    bool push(entry &incoming)
+    {
+        std::unique_lock<std::mutex> lock{queue_mutex_};
+
+        auto const capacity = std::size(queue_);
+        if (size_ == capacity)
+        {
+            switch (overflow_)
+            {
+            case overflow_policy::block :
+                not_full_.wait(lock, [this, capacity]
+                        { return size_ < capacity || stopped_.load(std::memory_order_acquire); });
+                if (size_ == capacity)
+                    return false;
+                break;
+            case overflow_policy::drop_newest :
+                dropped_.fetch_add(1, std::memory_order_relaxed);
+                return true;
+            case overflow_policy::drop_oldest :
+                head_ = (head_ + 1) % capacity;
+                --size_;
+                dropped_.fetch_add(1, std::memory_order_relaxed);
+                break;
+            }
+        }
+
+        std::swap(queue_[(head_ + size_) % capacity], incoming);
+        ++size_;
+
+        if (dispatcher_waiting_)
+            not_empty_.notify_one();
+
+        return true;
+    }
+
+    void dispatch()
+    {
+        for (;;)
+        {
+            std::size_t count = 0;
+
+            {
+                std::unique_lock<std::mutex> lock{queue_mutex_};
+                dispatcher_waiting_ = true;
+                not_empty_.wait(lock, [this] { return size_ || reader_done_; });
+                dispatcher_waiting_ = false;
+
+                if (!size_)
+                    return;
+
+                auto const capacity = std::size(queue_);
+                count = std::min(size_, std::size(batch_));
+                for (std::size_t i = 0 ; i < count ; ++i)
+                {
+                    std::swap(batch_[i], queue_[head_]);
+                    head_ = (head_ + 1) % capacity;
+                }
+                size_ -= count;
+                not_full_.notify_one();
+            }
+
+            {
+                std::lock_guard<std::mutex> lock{handlers_mutex_};
+                for (std::size_t i = 0 ; i < count ; ++i)
+                    targets_.push_back(find(batch_[i]));
+            }
+
+            for (std::size_t i = 0 ; i < count ; ++i)
+            {
+                if (!targets_[i])
+                    continue;
+                try
+                {
+                    (*targets_[i])(batch_[i].msg);
+                }
+                catch (...)
+                {
+                }
+            }
+
+            targets_.clear();
+        }
+    }
+
+    std::shared_ptr<handler> find(entry const &item) const
+    {
+        auto const &map = item.from == source::pattern ? patterns_ :
+                item.from == source::shard_channel ? shard_channels_ : channels_;
+        auto const &key = item.from == source::pattern ? item.msg.pattern : item.msg.channel;
+        auto const iter = map.find(key);
+        return iter != std::end(map) ? iter->second : nullptr;
+    }
+};
+
+}   // namespace rediscpp
+
+#endif  // !REDISCPP_SUBSCRIBER_H_
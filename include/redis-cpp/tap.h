@@ -0,0 +1,166 @@
+//-------------------------------------------------------------------
+//  redis-cpp
+//  https://github.com/tdv/redis-cpp
+//  Created:     10.2026
+//  Copyright 2020 Dmitry Tkachenko (tkachenkodmitryv@gmail.com)
+//  Distributed under the MIT License
+//  (See accompanying file LICENSE)
+//-------------------------------------------------------------------
+
+#ifndef REDISCPP_TAP_H_
+#define REDISCPP_TAP_H_
+
+// STD
+#include <algorithm>
+#include <cstddef>
+#include <iostream>
+#include <memory>
+#include <streambuf>
+#include <utility>
+
+// REDIS-CPP
+#include <redis-cpp/detail/config.h>
+
+namespace rediscpp
+{
+
+// The base of the streams which pass the data through to another stream.
+// set_deadline, set_timeout, get_error and wait_readable are applied to
+// the other stream, the data buffered by the wrapper is readable.
+class wrapped_stream
+    : public std::iostream
+{
+public:
+    [[nodiscard]]
+    virtual std::iostream& wrapped() const noexcept = 0;
+
+protected:
+    wrapped_stream()
+        : std::iostream{nullptr}
+    {
+    }
+};
+
+// Passes the data through to another stream and shows it to the observer:
+// observer.sent(data, size) gets the bytes right before they're written,
+// observer.received(data, size) gets them as soon as they're read from
+// the other stream. The writing and the reading sides can be used by
+// different threads, as the streams made by make_stream, the observer is
+// called by both of them.
+template <typename TObserver>
+class tapped_stream final
+    : public wrapped_stream
+{
+public:
+    template <typename ... TArgs>
+    explicit tapped_stream(std::shared_ptr<std::iostream> stream, TArgs && ... args)
+        : buffer_{std::move(stream), std::forward<TArgs>(args) ... }
+    {
+        rdbuf(&buffer_);
+    }
+
+    [[nodiscard]]
+    TObserver& observer() noexcept
+    {
+        return buffer_.observer();
+    }
+
+    [[nodiscard]]
+    std::iostream& wrapped() const noexcept override
+    {
+        return buffer_.stream();
+    }
+
+private:
+    class tap_streambuf final
+        : public std::streambuf
+    {
+    public:
+        template <typename ... TArgs>
+        explicit tap_streambuf(std::shared_ptr<std::iostream> stream, TArgs && ... args)
+            : stream_{std::move(stream)}
+            , source_{*stream_->rdbuf()}
+            , observer_{std::forward<TArgs>(args) ... }
+        {
+            setp(output_, output_ + sizeof(output_));
+            setg(input_, input_, input_);
+        }
+
+        TObserver& observer() noexcept
+        {
+            return observer_;
+        }
+
+        std::iostream& stream() const noexcept
+        {
+            return *stream_;
+        }
+
+    protected:
+        int_type overflow(int_type c) override
+        {
+            if (!send())
+                return traits_type::eof();
+            if (!traits_type::eq_int_type(c, traits_type::eof()))
+            {
+                *pptr() = traits_type::to_char_type(c);
+                pbump(1);
+            }
+            return traits_type::not_eof(c);
+        }
+
+        int sync() override
+        {
+            if (!send())
+                return -1;
+            return source_.pubsync();
+        }
+
+        // Waits for the data and takes what is already received.
+        int_type underflow() override
+        {
+            if (gptr() < egptr())
+                return traits_type::to_int_type(*gptr());
+
+            if (traits_type::eq_int_type(source_.sgetc(), traits_type::eof()))
+                return traits_type::eof();
+            auto const available = std::max<std::streamsize>(source_.in_avail(), 1);
+            auto const size = source_.sgetn(input_, std::min<std::streamsize>(available, sizeof(input_)));
+            if (size <= 0)
+                return traits_type::eof();
+
+            observer_.received(static_cast<char const *>(input_), static_cast<std::size_t>(size));
+            setg(input_, input_, input_ + size);
+            return traits_type::to_int_type(*gptr());
+        }
+
+        std::streamsize showmanyc() override
+        {
+            return source_.in_avail();
+        }
+
+    private:
+        std::shared_ptr<std::iostream> stream_;
+        std::streambuf &source_;
+        TObserver observer_;
+        char output_[16 * 1024];
+        char input_[16 * 1024];
+
+        bool send()
+        {
+            auto const size = static_cast<std::size_t>(pptr() - pbase());
+            if (!size)
+                return true;
+            observer_.sent(static_cast<char const *>(pbase()), size);
+            auto const written = source_.sputn(pbase(), static_cast<std::streamsize>(size));
+            setp(output_, output_ + sizeof(output_));
+            return written == static_cast<std::streamsize>(size);
+        }
+    };
+
+    tap_streambuf buffer_;
+};
+
+}   // namespace rediscpp
+
+#endif  // !REDISCPP_TAP_H_
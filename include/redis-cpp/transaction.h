@@ -0,0 +1,231 @@
+//-------------------------------------------------------------------
+//  redis-cpp
+//  https://github.com/tdv/redis-cpp
+//  Created:     10.2026
+//  Copyright 2020 Dmitry Tkachenko (tkachenkodmitryv@gmail.com)
+//  Distributed under the MIT License
+//  (See accompanying file LICENSE)
+//-------------------------------------------------------------------
+
+#ifndef REDISCPP_TRANSACTION_H_
+#define REDISCPP_TRANSACTION_H_
+
+// STD
+#include <cstddef>
+#include <iostream>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <variant>
+#include <vector>
+
+// REDIS-CPP
+#include <redis-cpp/detail/config.h>
+#include <redis-cpp/error.h>
+#include <redis-cpp/execute.h>
+#include <redis-cpp/resp/decoding.h>
+#include <redis-cpp/resp/serialization.h>
+#include <redis-cpp/value.h>
+
+namespace rediscpp
+{
+
+// MULTI, the commands and EXEC are sent in one write, the QUEUED replies
+// are skipped and the reply to EXEC is decoded, e.g. into a tuple with
+// an item per command. The commands are put into the stream when they're
+// added, so the stream mustn't be used for other commands until exec.
+class transaction final
+{
+public:
+    explicit transaction(std::iostream &stream) noexcept
+        : stream_{stream}
+    {
+    }
+
+    transaction(transaction const &) = delete;
+    transaction& operator = (transaction const &) = delete;
+
+    template <typename ... TArgs>
+    transaction& add(std::string_view name, TArgs && ... args)
+    {
+        begin();
+        execute_no_flush(stream_, std::move(name), std::forward<TArgs>(args) ... );
+        ++size_;
+        return *this;
+    }
+
+    [[nodiscard]]
+    std::size_t size() const noexcept
+    {
+        return size_;
+    }
+
+    // A watched key has been changed, EXEC has replied with Null.
+    [[nodiscard]]
+    bool aborted() const noexcept
+    {
+        return aborted_;
+    }
+
+    // T is for the whole reply, e.g. std::tuple<std::string, std::int64_t>.
+    // If a command can't be queued the error is returned, if a watched key
+    // has been changed it's errc::null_value and aborted() is true.
+    template <typename T>
+    [[nodiscard]]
+    result<T> try_exec_as()
+    {
+        error err;
+        if (!send(err))
+            return err;
+
+        resp::decoding::header hdr;
+        if (!hdr.read(stream_, err))
+            return err;
+        if (hdr.mark() == resp::detail::marker::array && hdr.is_null())
+        {
+            aborted_ = true;
+            return errc::null_value;
+        }
+        T res{};
+        if (!resp::decoding::get(stream_, hdr, res, err) && !err)
+            err = make_error_code(errc::type_mismatch);
+        if (err)
+            return err;
+        return res;
+    }
+
+    template <typename T>
+    [[nodiscard]]
+    T exec_as()
+    {
+        return try_exec_as<T>().value();
+    }
+
+    // The reply to EXEC is an array of the replies, which can be errors.
+    [[nodiscard]]
+    result<value> try_exec()
+    {
+        error err;
+        if (!send(err))
+            return err;
+        // A reply which is cut off is an I/O error.
+        auto read = value::try_read(stream_);
+        if (!read)
+            return read.error();
+
+        auto &reply = *read;
+        if (reply.is_error_message())
+        {
+            auto const message = reply.as_error_message();
+            return error{make_error_code(server_error_code(message)), std::string{message}};
+        }
+        if (reply.is_array() && std::get<resp::deserialization::array>(reply.get()).is_null())
+        {
+            aborted_ = true;
+            return errc::null_value;
+        }
+        return std::move(reply);
+    }
+
+    [[nodiscard]]
+    value exec()
+    {
+        return try_exec().value();
+    }
+
+private:
+    std::iostream &stream_;
+    std::size_t size_ = 0;
+    bool started_ = false;
+    bool aborted_ = false;
+
+    void begin()
+    {
+        if (started_)
+            return;
+        execute_no_flush(stream_, "multi");
+        started_ = true;
+    }
+
+    // Sends EXEC and reads the replies to MULTI and the commands. The first
+    // error is kept, EXEC replies with EXECABORT then.
+    bool send(error &err)
+    {
+        begin();
+        execute_no_flush(stream_, "exec");
+        std::flush(stream_);
+        if (!stream_)
+        {
+            err = make_error_code(errc::io_error);
+            return false;
+        }
+
+        for (std::size_t i = 0 ; i <= size_ ; ++i)
+        {
+            auto reply = resp::decoding::try_decode<std::string>(stream_);
+            if (reply)
+                continue;
+            if (resp::detail::decoding::is_fatal(reply.error()))
+            {
+                err = reply.error();
+                return false;
+            }
+            if (!err)
+                err = reply.error();
+        }
+        if (!err)
+            return true;
+
+        resp::decoding::header hdr;
+        error skipped;
+        if (hdr.read(stream_, skipped))
+            resp::detail::decoding::skip(stream_, hdr, skipped);
+        return false;
+    }
+};
+
+// Optimistic locking: the keys are watched, then `func` reads them from
+// the stream and adds the commands to the transaction. If a watched key is
+// changed before EXEC, it's run again, at most `attempts` times.
+template <typename T, typename TFunc>
+[[nodiscard]]
+inline result<T> try_transact_as(std::iostream &stream, std::vector<std::string_view> const &keys,
+        TFunc func, std::size_t attempts = 16)
+{
+    for (std::size_t attempt = 0 ; attempt < attempts ; ++attempt)
+    {
+        if (!keys.empty())
+        {
+            put(stream, resp::serialization::array_header{std::size(keys) + 1});
+            put(stream, resp::serialization::bulk_string{"watch"});
+            for (auto key : keys)
+                put(stream, resp::serialization::bulk_string{key});
+            std::flush(stream);
+            if (!stream)
+                return errc::io_error;
+            auto watched = resp::decoding::try_decode<std::string>(stream);
+            if (!watched)
+                return watched.error();
+        }
+
+        transaction tx{stream};
+        func(tx);
+        auto res = tx.try_exec_as<T>();
+        if (!tx.aborted())
+            return res;
+    }
+
+    return error{make_error_code(errc::null_value), "The watched keys are changed on each attempt."};
+}
+
+template <typename T, typename TFunc>
+[[nodiscard]]
+inline T transact_as(std::iostream &stream, std::vector<std::string_view> const &keys,
+        TFunc func, std::size_t attempts = 16)
+{
+    return try_transact_as<T>(stream, keys, std::move(func), attempts).value();
+}
+
+}   // namespace rediscpp
+
+#endif  // !REDISCPP_TRANSACTION_H_
@@ -12,14 +12,22 @@
 
 // STD
 #include <algorithm>
-#include <iosfwd>
+#include <charconv>
+#include <cstdlib>
+#include <istream>
 #include <iterator>
 #include <memory>
+#include <stdexcept>
+#include <string>
 #include <string_view>
+#include <system_error>
+#include <type_traits>
+#include <utility>
 #include <vector>
 
 // REDIS-CPP
 #include <redis-cpp/detail/config.h>
+#include <redis-cpp/error.h>
 #include <redis-cpp/resp/deserialization.h>
 #include <redis-cpp/resp/detail/overloaded.h>
 
@@ -174,6 +182,45 @@ public:
         return T{get_value<std::decay_t<T>>()};
     }
 
+    // Reads a value without throwing: a reply which is cut off by a broken
+    // connection is errc::io_error and a malformed one is errc::bad_format.
+    [[nodiscard]]
+    static result<value> try_read(std::istream &stream)
+    {
+        if (!stream || stream.peek() == std::istream::traits_type::eof())
+            return errc::io_error;
+        try
+        {
+            value res{stream};
+            // The last line of a reply which is cut off has no line feed.
+            if (!stream.good())
+                return errc::io_error;
+            return res;
+        }
+        catch (std::logic_error const &)
+        {
+            return stream.good() ? errc::bad_format : errc::io_error;
+        }
+    }
+
+    // Doesn't throw on an empty value, a server error, Null or a type mismatch.
+    // T is an integer, a floating point number, a string or a std::vector
+    // of them. Other types are decoded by resp::decoding::try_decode right
+    // from the stream.
+    template <typename T>
+    [[nodiscard]]
+    result<T> try_as() const
+    {
+        if (empty())
+            return errc::empty_value;
+        if (is_error_message())
+        {
+            auto const message = as_error_message();
+            return error{make_error_code(server_error_code(message)), std::string{message}};
+        }
+        return try_get_value<std::decay_t<T>>(*item_);
+    }
+
 private:
     char marker_;
     std::unique_ptr<item_type> item_;
@@ -224,6 +271,116 @@ private:
         return result;
     }
 
+    template <typename T>
+    struct is_vector
+        : std::false_type
+    {
+    };
+
+    template <typename T>
+    struct is_vector<std::vector<T>>
+        : std::bool_constant<std::is_integral_v<T> || std::is_floating_point_v<T> ||
+                std::is_same_v<T, std::string>>
+    {
+    };
+
+    template <typename T>
+    static std::enable_if_t<std::is_integral_v<T>, result<T>>
+    try_get_value(item_type const &item) noexcept
+    {
+        auto const *val = std::get_if<resp::deserialization::integer>(&item);
+        if (!val)
+            return errc::type_mismatch;
+        return static_cast<T>(val->get());
+    }
+
+    template <typename T>
+    static std::enable_if_t<
+            std::is_same_v<T, std::string_view> ||
+            std::is_same_v<T, std::string>, result<T>>
+    try_get_value(item_type const &item)
+    {
+        if (auto const *val = std::get_if<resp::deserialization::simple_string>(&item))
+            return T{val->get()};
+        if (auto const *val = std::get_if<resp::deserialization::bulk_string>(&item))
+        {
+            if (val->is_null())
+                return errc::null_value;
+            return T{val->get()};
+        }
+        if (auto const *val = std::get_if<resp::deserialization::array>(&item))
+        {
+            if (val->is_null())
+                return errc::null_value;
+        }
+        return errc::type_mismatch;
+    }
+
+    // Scores and other floating point replies are strings, e.g. ZSCORE.
+    template <typename T>
+    static std::enable_if_t<std::is_floating_point_v<T>, result<T>>
+    try_get_value(item_type const &item)
+    {
+        if (auto const *val = std::get_if<resp::deserialization::integer>(&item))
+            return static_cast<T>(val->get());
+
+        auto const string = try_get_value<std::string_view>(item);
+        if (!string)
+            return string.error();
+        auto number = *string;
+        if (!number.empty() && number.front() == '+')
+            number.remove_prefix(1);
+        if (number.empty())
+            return errc::type_mismatch;
+#ifdef __cpp_lib_to_chars
+        T res{};
+        auto const *end = std::data(number) + std::size(number);
+        auto const converted = std::from_chars(std::data(number), end, res);
+        if (converted.ec != std::errc{} || converted.ptr != end)
+            return errc::type_mismatch;
+        return res;
+#else
+        std::string const copy{number};
+        char *end = nullptr;
+        auto const res = std::strtold(copy.c_str(), &end);
+        if (end != copy.c_str() + std::size(copy))
+            return errc::type_mismatch;
+        return static_cast<T>(res);
+#endif  // !__cpp_lib_to_chars
+    }
+
+    template <typename T>
+    static std::enable_if_t<is_vector<T>::value, result<T>>
+    try_get_value(item_type const &item)
+    {
+        auto const *val = std::get_if<resp::deserialization::array>(&item);
+        if (!val)
+        {
+            auto const *string = std::get_if<resp::deserialization::bulk_string>(&item);
+            if (string && string->is_null())
+                return errc::null_value;
+            return errc::type_mismatch;
+        }
+        if (val->is_null())
+            return errc::null_value;
+
+        T res;
+        res.reserve(std::size(val->get()));
+        for (auto const &i : val->get())
+        {
+            if (auto const *message = std::get_if<resp::deserialization::error_message>(&i))
+            {
+                auto const text = message->get();
+                return error{make_error_code(server_error_code(text)), std::string{text}};
+            }
+            auto element = try_get_value<typename T::value_type>(i);
+            if (!element)
+                return element.error();
+            res.push_back(std::move(*element));
+        }
+        return res;
+    }
+
     template <typename T>
     std::vector<T> get_array() const
     {
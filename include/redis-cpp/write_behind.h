@@ -0,0 +1,347 @@
+//-------------------------------------------------------------------
+//  redis-cpp
+//  https://github.com/tdv/redis-cpp
+//  Created:     10.2026
+//  Copyright 2020 Dmitry Tkachenko (tkachenkodmitryv@gmail.com)
+//  Distributed under the MIT License
+//  (See accompanying file LICENSE)
+//-------------------------------------------------------------------
+
+#ifndef REDISCPP_WRITE_BEHIND_H_
+#define REDISCPP_WRITE_BEHIND_H_
+
+// STD
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <iostream>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+// REDIS-CPP
+#include <redis-cpp/detail/config.h>
+#include <redis-cpp/error.h>
+#include <redis-cpp/execute.h>
+#include <redis-cpp/loader.h>
+#include <redis-cpp/resp/decoding.h>
+#include <redis-cpp/resp/serialization.h>
+
+namespace rediscpp
+{
+
+struct flush_stats final
+{
+    // The calls which have been merged into the commands.
+    std::uint64_t updates = 0;
+    load_stats commands;
+    // The replicas which have acknowledged the batch with WAIT.
+    std::int64_t replicas = 0;
+    // A broken connection or too few replicas.
+    rediscpp::error failure;
+};
+
+struct write_behind_options final
+{
+    // The updates are sent each interval, or as soon as so many keys
+    // and hash fields have updates.
+    std::chrono::milliseconds interval{100};
+    std::size_t max_pending = 10000;
+    // Each batch is followed by WAIT for so many replicas, zero is for none.
+    std::size_t replicas = 0;
+    std::chrono::milliseconds replicas_timeout{1000};
+    // Called after each batch which isn't empty, in the order of the batches,
+    // e.g. to commit the position of the source of the updates.
+    std::function<void (flush_stats const &)> on_flush;
+};
+
+// Collects the updates of keys and hash fields and sends them in batches
+// from a background thread. The increments of a key are summed up and a value
+// overwrites the previous value and increments, so a batch has at most two
+// commands per key or field: SET (or HSET of all the fields of a hash)
+// and INCRBY (HINCRBY), unless the sum would overflow and another INCRBY
+// is sent for it. The updates of one key keep their order, the keys
+// don't. Unsent updates are lost on a crash, flush() and on_flush are for
+// the points where they have to be stored. The failed commands aren't sent
+// again, an increment could have been applied.
+class write_behind final
+{
+public:
+    explicit write_behind(std::shared_ptr<std::iostream> stream, write_behind_options options = {})
+        : stream_{std::move(stream)}
+        , options_{std::move(options)}
+    {
+        flusher_ = std::thread{[this] { run(); }};
+    }
+
+    write_behind(write_behind const &) = delete;
+    write_behind& operator = (write_behind const &) = delete;
+
+    // The rest of the updates are sent.
+    ~write_behind() noexcept
+    {
+        {
+            std::lock_guard<std::mutex> lock{mutex_};
+            stopped_ = true;
+        }
+        wake_.notify_one();
+        if (flusher_.joinable())
+            flusher_.join();
+        flush();
+    }
+
+    void set(std::string_view key, std::string_view value)
+    {
+        std::unique_lock<std::mutex> lock{mutex_};
+        assign(keys_[std::string{key}], value, lock);
+    }
+
+    void incrby(std::string_view key, std::int64_t delta)
+    {
+        std::unique_lock<std::mutex> lock{mutex_};
+        add(keys_[std::string{key}], delta, lock);
+    }
+
+    void hset(std::string_view key, std::string_view field, std::string_view value)
+    {
+        std::unique_lock<std::mutex> lock{mutex_};
+        assign(hashes_[std::string{key}][std::string{field}], value, lock);
+    }
+
+    void hincrby(std::string_view key, std::string_view field, std::int64_t delta)
+    {
+        std::unique_lock<std::mutex> lock{mutex_};
+        add(hashes_[std::string{key}][std::string{field}], delta, lock);
+    }
+
+    // Sends the collected updates and waits for the replies.
+    flush_stats flush() noexcept
+    {
+        std::lock_guard<std::mutex> sending{flush_mutex_};
+        keys keys_batch;
+        hashes hashes_batch;
+        flush_stats stats;
+        {
+            std::lock_guard<std::mutex> lock{mutex_};
+            std::swap(keys_batch, keys_);
+            std::swap(hashes_batch, hashes_);
+            stats.updates = updates_;
+            updates_ = 0;
+            pending_ = 0;
+        }
+        if (!stats.updates)
+            return stats;
+
+        // Nothing is thrown out of here, the failure is in the stats.
+        std::optional<loader> batch;
+        try
+        {
+            batch.emplace(*stream_);
+            send(*batch, keys_batch, hashes_batch);
+            stats.commands = batch->finish();
+            if (options_.replicas)
+                stats.failure = wait(stats.replicas);
+        }
+        catch (std::exception const &e)
+        {
+            if (batch)
+                stats.commands = batch->stats();
+            stats.failure = rediscpp::error{make_error_code(errc::io_error), e.what()};
+        }
+        catch (...)
+        {
+            if (batch)
+                stats.commands = batch->stats();
+            stats.failure = make_error_code(errc::io_error);
+        }
+
+        if (options_.on_flush)
+        {
+            try
+            {
+                options_.on_flush(stats);
+            }
+            catch (...)
+            {
+            }
+        }
+        return stats;
+    }
+
+    // The keys and hash fields which have updates to be sent.
+    [[nodiscard]]
+    std::size_t pending() const
+    {
+        std::lock_guard<std::mutex> lock{mutex_};
+        return pending_;
+    }
+
+private:
+    struct update final
+    {
+        std::optional<std::string> value;
+        std::int64_t delta = 0;
+        // The sums which would overflow with the next increments,
+        // each one is sent before the delta by an INCRBY of its own.
+        std::vector<std::int64_t> carried;
+        bool incremented = false;
+    };
+
+    using keys = std::unordered_map<std::string, update>;
+    using hashes = std::unordered_map<std::string, keys>;
+
+    std::shared_ptr<std::iostream> stream_;
+    write_behind_options const options_;
+
+    mutable std::mutex mutex_;
+    std::condition_variable wake_;
+    keys keys_;
+    hashes hashes_;
+    std::size_t pending_ = 0;
+    std::uint64_t updates_ = 0;
+    bool stopped_ = false;
+
+    // Only one batch is sent at a time.
+    std::mutex flush_mutex_;
+    std::thread flusher_;
+
+    void assign(update &item, std::string_view value, std::unique_lock<std::mutex> &lock)
+    {
+        auto const added = !item.value && !item.incremented;
+        item.value = std::string{value};
+        item.delta = 0;
+        item.carried.clear();
+        item.incremented = false;
+        updated(added, lock);
+    }
+
+    void add(update &item, std::int64_t delta, std::unique_lock<std::mutex> &lock)
+    {
+        auto const added = !item.value && !item.incremented;
+        if (overflows(item.delta, delta))
+        {
+            item.carried.push_back(item.delta);
+            item.delta = delta;
+        }
+        else
+        {
+            item.delta += delta;
+        }
+        item.incremented = true;
+        updated(added, lock);
+    }
+
+    static bool overflows(std::int64_t sum, std::int64_t delta) noexcept
+    {
+#if defined(__GNUC__) || defined(__clang__)
+        return __builtin_add_overflow(sum, delta, &sum);
+#else
+        return delta > 0 ? sum > std::numeric_limits<std::int64_t>::max() - delta :
+                sum < std::numeric_limits<std::int64_t>::min() - delta;
+#endif  // !__GNUC__ && !__clang__
+    }
+
+    void updated(bool added, std::unique_lock<std::mutex> &lock)
+    {
+        ++updates_;
+        if (added && ++pending_ == options_.max_pending)
+        {
+            lock.unlock();
+            wake_.notify_one();
+        }
+    }
+
+    void run()
+    {
+        std::unique_lock<std::mutex> lock{mutex_};
+        while (!stopped_)
+        {
+            wake_.wait_for(lock, options_.interval,
+                    [this] { return stopped_ || pending_ >= options_.max_pending; });
+            if (stopped_)
+                break;
+            lock.unlock();
+            flush();
+            lock.lock();
+        }
+    }
+
+    static void send(loader &batch, keys const &keys_batch, hashes const &hashes_batch)
+    {
+        for (auto const &[key, item] : keys_batch)
+        {
+            if (item.value)
+                batch.add("set", key, *item.value);
+            if (!item.incremented)
+                continue;
+            for (auto const sum : item.carried)
+                batch.add("incrby", key, std::to_string(sum));
+            batch.add("incrby", key, std::to_string(item.delta));
+        }
+
+        for (auto const &[key, fields] : hashes_batch)
+        {
+            std::size_t values = 0;
+            for (auto const &field : fields)
+                values += field.second.value.has_value();
+            if (values)
+            {
+                batch.add_with(
+                        [&key = key, &fields = fields, values] (std::ostream &stream)
+                        {
+                            put(stream, resp::serialization::array_header{2 + values * 2});
+                            put(stream, resp::serialization::bulk_string{"hset"});
+                            put(stream, resp::serialization::bulk_string{key});
+                            for (auto const &[field, item] : fields)
+                            {
+                                if (!item.value)
+                                    continue;
+                                put(stream, resp::serialization::bulk_string{field});
+                                put(stream, resp::serialization::bulk_string{*item.value});
+                            }
+                        }
+                    );
+            }
+            for (auto const &[field, item] : fields)
+            {
+                if (!item.incremented)
+                    continue;
+                for (auto const sum : item.carried)
+                    batch.add("hincrby", key, field, std::to_string(sum));
+                batch.add("hincrby", key, field, std::to_string(item.delta));
+            }
+        }
+    }
+
+    rediscpp::error wait(std::int64_t &replicas)
+    {
+        execute_no_flush(*stream_, "wait", std::to_string(options_.replicas),
+                std::to_string(options_.replicas_timeout.count()));
+        std::flush(*stream_);
+        if (!*stream_)
+            return make_error_code(errc::io_error);
+        auto acked = resp::decoding::try_decode<std::int64_t>(*stream_);
+        if (!acked)
+            return acked.error();
+        replicas = *acked;
+        if (replicas >= static_cast<std::int64_t>(options_.replicas))
+            return {};
+        return rediscpp::error{make_error_code(errc::server_error),
+                "The batch is acknowledged by " + std::to_string(replicas) + " replicas of " +
+                std::to_string(options_.replicas) + "."};
+    }
+};
+
+}   // namespace rediscpp
+
+#endif  // !REDISCPP_WRITE_BEHIND_H_
@@ -0,0 +1,253 @@
+//-------------------------------------------------------------------
+//  redis-cpp
+//  https://github.com/tdv/redis-cpp
+//  Created:     10.2026
+//  Copyright 2020 Dmitry Tkachenko (tkachenkodmitryv@gmail.com)
+//  Distributed under the MIT License
+//  (See accompanying file LICENSE)
+//-------------------------------------------------------------------
+
+#ifndef REDISCPP_TEST_LOOPBACK_SERVER_H_
+#define REDISCPP_TEST_LOOPBACK_SERVER_H_
+
+// STD
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdlib>
+#include <functional>
+#include <initializer_list>
+#include <iostream>
+#include <istream>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+// BOOST
+#include <boost/asio.hpp>
+
+namespace loopback
+{
+
+inline int& failures() noexcept
+{
+    static int count = 0;
+    return count;
+}
+
+inline void check(bool condition, char const *what, int line)
+{
+    if (condition)
+        return;
+    ++failures();
+    std::cerr << "Line " << line << ": " << what << " failed." << std::endl;
+}
+
+#define LOOPBACK_CHECK(condition) ::loopback::check((condition), #condition, __LINE__)
+
+// A command as a client sends it, an array of bulk strings.
+inline std::string command(std::initializer_list<std::string_view> args)
+{
+    auto res = "*" + std::to_string(std::size(args)) + "\r\n";
+    for (auto const &arg : args)
+    {
+        res.append("$" + std::to_string(std::size(arg)) + "\r\n");
+        res.append(arg);
+        res.append("\r\n");
+    }
+    return res;
+}
+
+inline std::string bulk_string(std::string_view data)
+{
+    return "$" + std::to_string(std::size(data)) + "\r\n" + std::string{data} + "\r\n";
+}
+
+// Waits for the condition no longer than the timeout.
+template <typename TCondition>
+bool eventually(TCondition condition,
+        std::chrono::milliseconds timeout = std::chrono::milliseconds{5000})
+{
+    auto const until = std::chrono::steady_clock::now() + timeout;
+    while (!condition())
+    {
+        if (std::chrono::steady_clock::now() >= until)
+            return false;
+        std::this_thread::sleep_for(std::chrono::milliseconds{5});
+    }
+    return true;
+}
+
+// An accepted connection. It's read by its own thread, the replies
+// can be written by any thread.
+class connection final
+{
+public:
+    explicit connection(boost::asio::ip::tcp::socket socket)
+        : socket_{std::move(socket)}
+    {
+    }
+
+    connection(connection const &) = delete;
+    connection& operator = (connection const &) = delete;
+
+    // The arguments of the next command, nothing when the client is gone.
+    std::optional<std::vector<std::string>> read_command()
+    {
+        auto header = read_line();
+        if (!header || header->empty() || header->front() != '*')
+            return std::nullopt;
+
+        std::vector<std::string> res(static_cast<std::size_t>(std::stoul(header->substr(1))));
+        for (auto &arg : res)
+        {
+            auto length = read_line();
+            if (!length || length->empty() || length->front() != '$')
+                return std::nullopt;
+            auto const size = static_cast<std::size_t>(std::stoul(length->substr(1)));
+            if (!read_exactly(size + 2, arg))
+                return std::nullopt;
+            arg.resize(size);
+        }
+        return res;
+    }
+
+    void write(std::string_view data)
+    {
+        std::lock_guard<std::mutex> lock{write_mutex_};
+        boost::system::error_code ec;
+        boost::asio::write(socket_, boost::asio::buffer(std::data(data), std::size(data)), ec);
+    }
+
+    void shutdown() noexcept
+    {
+        boost::system::error_code ec;
+        socket_.shutdown(boost::asio::ip::tcp::socket::shutdown_both, ec);
+    }
+
+private:
+    boost::asio::ip::tcp::socket socket_;
+    boost::asio::streambuf input_;
+    std::mutex write_mutex_;
+
+    std::optional<std::string> read_line()
+    {
+        boost::system::error_code ec;
+        boost::asio::read_until(socket_, input_, "\r\n", ec);
+        if (ec)
+            return std::nullopt;
+        std::istream stream{&input_};
+        std::string line;
+        std::getline(stream, line);
+        line.pop_back();
+        return line;
+    }
+
+    bool read_exactly(std::size_t size, std::string &data)
+    {
+        if (input_.size() < size)
+        {
+            boost::system::error_code ec;
+            boost::asio::read(socket_, input_, boost::asio::transfer_exactly(size - input_.size()), ec);
+            if (ec)
+                return false;
+        }
+        auto const begin = boost::asio::buffers_begin(input_.data());
+        data.assign(begin, begin + static_cast<std::ptrdiff_t>(size));
+        input_.consume(size);
+        return true;
+    }
+};
+
+// A stand-in for a server on 127.0.0.1 with a port chosen by the system.
+// Each connection is served by the handler on a thread of its own.
+// The connections are shut down and the threads are joined when
+// the server is destroyed.
+class server final
+{
+public:
+    using handler = std::function<void (connection &)>;
+
+    explicit server(handler func)
+        : handler_{std::move(func)}
+        , acceptor_{context_, {boost::asio::ip::make_address("127.0.0.1"), 0}}
+    {
+        accepting_ = std::thread{[this] { accept(); }};
+    }
+
+    server(server const &) = delete;
+    server& operator = (server const &) = delete;
+
+    ~server() noexcept
+    {
+        stopped_ = true;
+        try
+        {
+            // The accepting thread is woken up by a connection.
+            boost::asio::ip::tcp::socket wake{context_};
+            wake.connect(acceptor_.local_endpoint());
+        }
+        catch (...)
+        {
+        }
+        accepting_.join();
+
+        {
+            std::lock_guard<std::mutex> lock{mutex_};
+            for (auto &item : connections_)
+                item->shutdown();
+        }
+        for (auto &thread : threads_)
+            thread.join();
+    }
+
+    [[nodiscard]]
+    std::string port() const
+    {
+        return std::to_string(acceptor_.local_endpoint().port());
+    }
+
+    // The number of the accepted connections.
+    [[nodiscard]]
+    std::size_t accepted() const
+    {
+        std::lock_guard<std::mutex> lock{mutex_};
+        return std::size(connections_);
+    }
+
+private:
+    handler handler_;
+    boost::asio::io_context context_;
+    boost::asio::ip::tcp::acceptor acceptor_;
+    std::atomic<bool> stopped_{false};
+
+    mutable std::mutex mutex_;
+    std::vector<std::shared_ptr<connection>> connections_;
+    std::vector<std::thread> threads_;
+    std::thread accepting_;
+
+    void accept()
+    {
+        while (!stopped_)
+        {
+            boost::asio::ip::tcp::socket socket{context_};
+            boost::system::error_code ec;
+            acceptor_.accept(socket, ec);
+            if (ec || stopped_)
+                return;
+
+            auto item = std::make_shared<connection>(std::move(socket));
+            std::lock_guard<std::mutex> lock{mutex_};
+            connections_.push_back(item);
+            threads_.emplace_back([this, item] { handler_(*item); });
+        }
+    }
+};
+
+}   // namespace loopback
+
+#endif  // !REDISCPP_TEST_LOOPBACK_SERVER_H_
@@ -0,0 +1,183 @@
+//-------------------------------------------------------------------
+//  redis-cpp
+//  https://github.com/tdv/redis-cpp
+//  Created:     10.2026
+//  Copyright 2020 Dmitry Tkachenko (tkachenkodmitryv@gmail.com)
+//  Distributed under the MIT License
+//  (See accompanying file LICENSE)
+//-------------------------------------------------------------------
+
+// A primary makes a full resynchronization, the snapshot is sent both
+// as a bulk with the length and as a diskless transfer with an EOF mark,
+// then a stream of commands with GETACK. The acknowledged offsets are
+// checked against the bytes of the commands.
+
+// STD
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <exception>
+#include <future>
+#include <iostream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// REDIS-CPP
+#include <redis-cpp/replication.h>
+
+// TEST
+#include "loopback_server.h"
+
+namespace
+{
+
+constexpr std::int64_t start_offset = 100;
+std::string const replid(40, 'a');
+std::string const mark(40, 'm');
+
+// Bytes of all the values, the mark and CRLF among them.
+std::string make_rdb()
+{
+    std::string res;
+    std::uint32_t state = 1;
+    while (std::size(res) < 100 * 1024)
+    {
+        state = state * 1103515245u + 12345u;
+        res.push_back(static_cast<char>(state >> 24));
+        if (std::size(res) % 1000 == 0)
+            res.append(mark.substr(0, 20) + "\r\n");
+    }
+    return res;
+}
+
+struct primary_script final
+{
+    bool eof_mark = false;
+    std::string rdb = make_rdb();
+    std::string ping = loopback::command({"PING"});
+    std::string set = loopback::command({"SET", "k", "v"});
+    std::string getack = loopback::command({"REPLCONF", "GETACK", "*"});
+    std::string del = loopback::command({"DEL", "k"});
+    // The offsets of REPLCONF ACK.
+    std::promise<std::vector<std::string>> acks;
+
+    void operator () (loopback::connection &conn)
+    {
+        std::vector<std::string> res;
+        auto next_ack = [&conn, &res]
+            {
+                auto cmd = conn.read_command();
+                if (!cmd || std::size(*cmd) != 3 || (*cmd)[1] != "ack")
+                    return false;
+                res.push_back((*cmd)[2]);
+                return true;
+            };
+
+        auto capa = conn.read_command();
+        if (!capa || std::size(*capa) != 5 || (*capa)[0] != "replconf")
+            return acks.set_value({});
+        conn.write("+OK\r\n");
+        auto psync = conn.read_command();
+        if (!psync || std::size(*psync) != 3 || (*psync)[0] != "psync")
+            return acks.set_value({});
+
+        conn.write("+FULLRESYNC " + replid + " " + std::to_string(start_offset) + "\r\n");
+        // A keepalive while the snapshot is being made.
+        conn.write("\n");
+        if (eof_mark)
+            conn.write("$EOF:" + mark + "\r\n" + rdb + mark);
+        else
+            conn.write("$" + std::to_string(std::size(rdb)) + "\r\n" + rdb);
+
+        // The commands go after the first ACK, as a diskless primary does.
+        if (next_ack())
+        {
+            conn.write(ping + set + getack);
+            if (next_ack())
+            {
+                conn.write(del);
+                next_ack();
+            }
+        }
+        acks.set_value(std::move(res));
+    }
+};
+
+void run(bool eof_mark)
+{
+    primary_script script;
+    script.eof_mark = eof_mark;
+    auto acks = script.acks.get_future();
+    loopback::server primary{[&script] (loopback::connection &conn) { script(conn); }};
+
+    rediscpp::replication_options options;
+    // Only the acknowledgements which are asked for and the last one.
+    options.ack_interval = std::chrono::seconds{60};
+    rediscpp::replication_consumer consumer{"127.0.0.1", primary.port(), options};
+
+    std::string snapshot;
+    std::size_t ends = 0;
+    std::vector<std::string> commands;
+    std::vector<std::int64_t> offsets;
+    auto const err = consumer.run(
+            [&] (std::string_view chunk)
+            {
+                if (chunk.empty())
+                    ++ends;
+                snapshot.append(chunk);
+            },
+            [&] (std::vector<std::string_view> const &args, std::int64_t offset)
+            {
+                commands.emplace_back(args.front());
+                offsets.push_back(offset);
+                if (args.front() == "DEL")
+                    consumer.stop();
+            }
+        );
+
+    LOOPBACK_CHECK(!err);
+    if (err)
+        std::cerr << "run: " << err.code().message() << " " << err.message() << std::endl;
+    LOOPBACK_CHECK(snapshot == script.rdb);
+    LOOPBACK_CHECK(ends == 1);
+    LOOPBACK_CHECK(consumer.replid() == replid);
+    LOOPBACK_CHECK(consumer.full_syncs() == 1);
+
+    auto const ping = static_cast<std::int64_t>(std::size(script.ping));
+    auto const set = static_cast<std::int64_t>(std::size(script.set));
+    auto const getack = static_cast<std::int64_t>(std::size(script.getack));
+    auto const del = static_cast<std::int64_t>(std::size(script.del));
+    auto const last = start_offset + ping + set + getack + del;
+
+    LOOPBACK_CHECK((commands == std::vector<std::string>{"SET", "DEL"}));
+    LOOPBACK_CHECK((offsets == std::vector<std::int64_t>{start_offset + ping + set, last}));
+    LOOPBACK_CHECK(consumer.offset() == last);
+
+    // GETACK isn't included in the offset it asks for.
+    auto const ready = acks.wait_for(std::chrono::seconds{10}) == std::future_status::ready;
+    LOOPBACK_CHECK(ready);
+    LOOPBACK_CHECK(ready && (acks.get() == std::vector<std::string>{
+            std::to_string(start_offset),
+            std::to_string(start_offset + ping + set),
+            std::to_string(last)
+        }));
+}
+
+}   // namespace
+
+int main()
+{
+    try
+    {
+        run(false);
+        run(true);
+    }
+    catch (std::exception const &e)
+    {
+        std::cerr << "Error: " << e.what() << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    return loopback::failures() ? EXIT_FAILURE : EXIT_SUCCESS;
+}
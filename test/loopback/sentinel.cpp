@@ -0,0 +1,181 @@
+//-------------------------------------------------------------------
+//  redis-cpp
+//  https://github.com/tdv/redis-cpp
+//  Created:     10.2026
+//  Copyright 2020 Dmitry Tkachenko (tkachenkodmitryv@gmail.com)
+//  Distributed under the MIT License
+//  (See accompanying file LICENSE)
+//-------------------------------------------------------------------
+
+// A sentinel resolves the primary with GET-MASTER-ADDR-BY-NAME, then
+// announces a failover with +switch-master. The lease taken before
+// the switch becomes stale, the next one goes to the new primary.
+
+// STD
+#include <algorithm>
+#include <cctype>
+#include <cstdlib>
+#include <exception>
+#include <iostream>
+#include <mutex>
+#include <string>
+
+// REDIS-CPP
+#include <redis-cpp/sentinel.h>
+#include <redis-cpp/execute.h>
+
+// TEST
+#include "loopback_server.h"
+
+namespace
+{
+
+std::string lower(std::string str)
+{
+    std::transform(std::begin(str), std::end(str), std::begin(str),
+            [] (unsigned char ch) { return static_cast<char>(std::tolower(ch)); });
+    return str;
+}
+
+// Replies to ROLE as a primary and to GET with its own name.
+loopback::server::handler primary(std::string name)
+{
+    return [name] (loopback::connection &conn)
+        {
+            while (auto cmd = conn.read_command())
+            {
+                auto const command = lower(cmd->front());
+                if (command == "role")
+                    conn.write("*3\r\n$6\r\nmaster\r\n:0\r\n*0\r\n");
+                else if (command == "ping")
+                    conn.write("+PONG\r\n");
+                else if (command == "get")
+                    conn.write(loopback::bulk_string(name));
+                else
+                    conn.write("-ERR unknown command\r\n");
+            }
+        };
+}
+
+class fake_sentinel final
+{
+public:
+    explicit fake_sentinel(std::string primary_port)
+        : primary_port_{std::move(primary_port)}
+    {
+    }
+
+    loopback::server::handler handler()
+    {
+        return [this] (loopback::connection &conn) { serve(conn); };
+    }
+
+    bool subscribed() const
+    {
+        std::lock_guard<std::mutex> lock{mutex_};
+        return watcher_ != nullptr;
+    }
+
+    // Switches the primary and announces it to the subscriber.
+    void switch_master(std::string const &port)
+    {
+        std::lock_guard<std::mutex> lock{mutex_};
+        auto const payload = "mymaster 127.0.0.1 " + primary_port_ + " 127.0.0.1 " + port;
+        primary_port_ = port;
+        watcher_->write("*3\r\n" + loopback::bulk_string("message") +
+                loopback::bulk_string("+switch-master") + loopback::bulk_string(payload));
+    }
+
+private:
+    mutable std::mutex mutex_;
+    std::string primary_port_;
+    loopback::connection *watcher_ = nullptr;
+
+    void serve(loopback::connection &conn)
+    {
+        while (auto cmd = conn.read_command())
+        {
+            auto const command = lower(cmd->front());
+            std::lock_guard<std::mutex> lock{mutex_};
+            if (command == "sentinel" && std::size(*cmd) == 3 &&
+                    lower((*cmd)[1]) == "get-master-addr-by-name")
+            {
+                if ((*cmd)[2] == "mymaster")
+                {
+                    conn.write("*2\r\n" + loopback::bulk_string("127.0.0.1") +
+                            loopback::bulk_string(primary_port_));
+                }
+                else
+                {
+                    conn.write("*-1\r\n");
+                }
+            }
+            else if (command == "subscribe" && std::size(*cmd) == 2)
+            {
+                conn.write("*3\r\n" + loopback::bulk_string("subscribe") +
+                        loopback::bulk_string((*cmd)[1]) + ":1\r\n");
+                watcher_ = &conn;
+            }
+            else if (command == "ping")
+            {
+                if (watcher_ == &conn)
+                    conn.write("*2\r\n" + loopback::bulk_string("pong") + loopback::bulk_string(""));
+                else
+                    conn.write("+PONG\r\n");
+            }
+            else
+            {
+                conn.write("-ERR unknown command\r\n");
+            }
+        }
+
+        std::lock_guard<std::mutex> lock{mutex_};
+        if (watcher_ == &conn)
+            watcher_ = nullptr;
+    }
+};
+
+}   // namespace
+
+int main()
+{
+    try
+    {
+        loopback::server first{primary("first")};
+        loopback::server second{primary("second")};
+        fake_sentinel state{first.port()};
+        loopback::server sentinel_server{state.handler()};
+
+        rediscpp::sentinel_options options;
+        options.watch_interval = std::chrono::milliseconds{100};
+        rediscpp::sentinel sentinel{{{"127.0.0.1", sentinel_server.port()}}, "mymaster", options};
+        rediscpp::sentinel_pool pool{sentinel};
+
+        LOOPBACK_CHECK(sentinel.primary().second == first.port());
+        auto const generation = sentinel.generation();
+
+        auto old = pool.acquire();
+        LOOPBACK_CHECK(!old.stale());
+        LOOPBACK_CHECK(rediscpp::execute_as<std::string>(*old, "get", "name") == "first");
+
+        LOOPBACK_CHECK(loopback::eventually([&state] { return state.subscribed(); }));
+        state.switch_master(second.port());
+        LOOPBACK_CHECK(loopback::eventually([&] { return sentinel.generation() != generation; }));
+        LOOPBACK_CHECK(sentinel.primary().second == second.port());
+
+        // The old lease still goes to the old primary.
+        LOOPBACK_CHECK(old.stale());
+        LOOPBACK_CHECK(rediscpp::execute_as<std::string>(*old, "get", "name") == "first");
+
+        auto next = pool.acquire();
+        LOOPBACK_CHECK(!next.stale());
+        LOOPBACK_CHECK(rediscpp::execute_as<std::string>(*next, "get", "name") == "second");
+    }
+    catch (std::exception const &e)
+    {
+        std::cerr << "Error: " << e.what() << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    return loopback::failures() ? EXIT_FAILURE : EXIT_SUCCESS;
+}